@@ -0,0 +1,631 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef ADAPTIVESCAN_H
+#define ADAPTIVESCAN_H
+
+#include "iplugininterface.h"
+#include "common/scanplanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Adaptive angular sampling.
+//
+// The scan starts on a coarse AZ/EL grid and recursively splits cells in
+// four (or two, for a single cut) where the measured level changes:
+//   - gradient:  corner levels of the cell differ by more than gradientDb
+//   - curvature: the level measured at the cell center differs from the
+//                bilinear interpolation of its corners by more than
+//                curvatureDb (catches nulls and lobe tops between corners)
+//   - peak:      the cell holds the strongest level measured so far
+// Cells stop splitting at minCellDeg, and cells lying entirely more than
+// dynamicRangeDb below the strongest measured level are not refined. Each
+// refinement level is measured as one batch whose order comes from
+// ScanPlanner, so the positioner is driven incrementally along a short
+// path; when the point budget runs low, the cells with the largest
+// errors are split first.
+//
+// Levels are in dB and are interpolated bilinearly inside the leaf cells,
+// so pattern metrics can be computed from the adaptive result the same way
+// as from a uniform grid (see computePatternMetrics()).
+
+struct AdaptiveScanSettings {
+    double azMin = -90.0;
+    double azMax = 90.0;
+    double elMin = 0.0;
+    double elMax = 0.0;         // elMin == elMax scans a single AZ cut
+    double pol = 0.0;
+    double coarseStepDeg = 10.0;
+    double minCellDeg = 0.5;
+    double gradientDb = 1.5;
+    double curvatureDb = 0.5;
+    double dynamicRangeDb = 40.0;   // 0 refines at any level
+    size_t maxPoints = 10000;
+};
+
+// Measures the level at one angle; returns false on failure
+typedef std::function<bool(const ScanAngle &angle, double &levelDb)> AdaptiveProbe;
+
+struct PatternMetrics {
+    double peakDb = std::numeric_limits<double>::quiet_NaN();
+    double peakAz = std::numeric_limits<double>::quiet_NaN();
+    double peakEl = std::numeric_limits<double>::quiet_NaN();
+    double beamwidthAzDeg = std::numeric_limits<double>::quiet_NaN();   // -3 dB
+    double beamwidthElDeg = std::numeric_limits<double>::quiet_NaN();
+    double sidelobeAzDb = std::numeric_limits<double>::quiet_NaN();     // relative to peak
+    double sidelobeElDb = std::numeric_limits<double>::quiet_NaN();
+};
+
+namespace PatternAnalysis {
+
+// -3 dB width and highest sidelobe (beyond the first null on either side)
+// of a cut sampled at equal spacing
+inline void analyzeCut(const std::vector<double> &levels, double spacingDeg,
+                       double &beamwidthDeg, double &sidelobeDb)
+{
+    beamwidthDeg = std::numeric_limits<double>::quiet_NaN();
+    sidelobeDb = std::numeric_limits<double>::quiet_NaN();
+    if (levels.size() < 3) {
+        return;
+    }
+    size_t peak = static_cast<size_t>(std::max_element(levels.begin(), levels.end()) - levels.begin());
+    double threshold = levels[peak] - 3.0;
+
+    // Crossing positions, interpolated between samples
+    double left = 0.0;
+    double right = static_cast<double>(levels.size() - 1);
+    for (size_t i = peak; i > 0; i--) {
+        if (levels[i - 1] < threshold) {
+            left = static_cast<double>(i - 1) + (threshold - levels[i - 1]) / (levels[i] - levels[i - 1]);
+            break;
+        }
+    }
+    for (size_t i = peak; i + 1 < levels.size(); i++) {
+        if (levels[i + 1] < threshold) {
+            right = static_cast<double>(i) + (levels[i] - threshold) / (levels[i] - levels[i + 1]);
+            break;
+        }
+    }
+    beamwidthDeg = (right - left) * spacingDeg;
+
+    // Walk down the main lobe from the -3 dB points to the first local
+    // minimum on each side
+    size_t nullLeft = static_cast<size_t>(std::floor(left));
+    while (nullLeft > 0 && levels[nullLeft - 1] <= levels[nullLeft]) {
+        nullLeft--;
+    }
+    size_t nullRight = std::min(levels.size() - 1, static_cast<size_t>(std::ceil(right)));
+    while (nullRight + 1 < levels.size() && levels[nullRight + 1] <= levels[nullRight]) {
+        nullRight++;
+    }
+    double sidelobe = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < nullLeft; i++) {
+        sidelobe = std::max(sidelobe, levels[i]);
+    }
+    for (size_t i = nullRight + 1; i < levels.size(); i++) {
+        sidelobe = std::max(sidelobe, levels[i]);
+    }
+    if (sidelobe > -std::numeric_limits<double>::infinity()) {
+        sidelobeDb = sidelobe - levels[peak];
+    }
+}
+
+} // namespace PatternAnalysis
+
+// Pattern metrics of any level function (adaptive result, uniform grid,
+// model), evaluated on a regular grid with the given resolution
+inline PatternMetrics computePatternMetrics(const std::function<double(double az, double el)> &level,
+                                            double azMin, double azMax, double elMin, double elMax,
+                                            double resolutionDeg)
+{
+    PatternMetrics metrics;
+    std::vector<double> az = ScanGrid::range(azMin, azMax, resolutionDeg);
+    std::vector<double> el = ScanGrid::range(elMin, elMax, elMax > elMin ? resolutionDeg : 0.0);
+
+    double best = -std::numeric_limits<double>::infinity();
+    size_t bestAz = 0;
+    size_t bestEl = 0;
+    for (size_t e = 0; e < el.size(); e++) {
+        for (size_t a = 0; a < az.size(); a++) {
+            double value = level(az[a], el[e]);
+            if (value > best) {
+                best = value;
+                bestAz = a;
+                bestEl = e;
+            }
+        }
+    }
+    metrics.peakDb = best;
+    metrics.peakAz = az[bestAz];
+    metrics.peakEl = el[bestEl];
+
+    std::vector<double> cut;
+    for (double a : az) {
+        cut.push_back(level(a, el[bestEl]));
+    }
+    PatternAnalysis::analyzeCut(cut, resolutionDeg, metrics.beamwidthAzDeg, metrics.sidelobeAzDb);
+    if (el.size() > 1) {
+        cut.clear();
+        for (double e : el) {
+            cut.push_back(level(az[bestAz], e));
+        }
+        PatternAnalysis::analyzeCut(cut, resolutionDeg, metrics.beamwidthElDeg, metrics.sidelobeElDb);
+    }
+    return metrics;
+}
+
+struct AdaptiveSample {
+    ScanAngle angle;
+    double levelDb;
+    int depth;          // refinement level that requested the sample (0 = coarse)
+};
+
+class AdaptiveScanResult
+{
+public:
+    struct Cell {
+        double az0, az1, el0, el1;
+        int depth;
+        int firstChild;     // -1 for leaves
+        int childCount;
+    };
+
+    const std::vector<AdaptiveSample> &samples() const { return m_samples; }
+    const std::vector<Cell> &cells() const { return m_cells; }
+    const AdaptiveScanSettings &settings() const { return m_settings; }
+    bool complete() const { return m_complete; }
+    double elapsedS() const { return m_elapsedS; }
+
+    // Level at any angle inside the scanned area (bilinear in the leaf cell)
+    double levelAt(double az, double el) const
+    {
+        if (m_cells.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        int index = -1;
+        for (size_t i = 0; i < m_rootCount && index < 0; i++) {
+            if (contains(m_cells[i], az, el)) {
+                index = static_cast<int>(i);
+            }
+        }
+        if (index < 0) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        while (m_cells[index].firstChild >= 0) {
+            const Cell &cell = m_cells[index];
+            int next = cell.firstChild;
+            for (int c = 0; c < cell.childCount; c++) {
+                if (contains(m_cells[cell.firstChild + c], az, el)) {
+                    next = cell.firstChild + c;
+                    break;
+                }
+            }
+            index = next;
+        }
+        return interpolate(m_cells[index], az, el);
+    }
+
+    PatternMetrics metrics(double resolutionDeg) const
+    {
+        return computePatternMetrics([this](double az, double el) { return levelAt(az, el); },
+                                     m_settings.azMin, m_settings.azMax,
+                                     m_settings.elMin, m_settings.elMax, resolutionDeg);
+    }
+
+private:
+    friend class AdaptiveScanner;
+
+    typedef std::pair<long long, long long> Key;
+
+    static Key key(double az, double el)
+    {
+        // Micro-degree resolution, so shared cell corners are measured once
+        return Key(std::llround(az * 1e6), std::llround(el * 1e6));
+    }
+
+    static bool contains(const Cell &cell, double az, double el)
+    {
+        const double eps = 1e-9;
+        return az >= cell.az0 - eps && az <= cell.az1 + eps && el >= cell.el0 - eps && el <= cell.el1 + eps;
+    }
+
+    bool has(double az, double el) const
+    {
+        return m_levels.find(key(az, el)) != m_levels.end();
+    }
+
+    double level(double az, double el) const
+    {
+        auto it = m_levels.find(key(az, el));
+        return it != m_levels.end() ? it->second : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double interpolate(const Cell &cell, double az, double el) const
+    {
+        double u = cell.az1 > cell.az0 ? (az - cell.az0) / (cell.az1 - cell.az0) : 0.0;
+        double v = cell.el1 > cell.el0 ? (el - cell.el0) / (cell.el1 - cell.el0) : 0.0;
+        u = std::min(1.0, std::max(0.0, u));
+        v = std::min(1.0, std::max(0.0, v));
+        double l00 = level(cell.az0, cell.el0);
+        double l10 = level(cell.az1, cell.el0);
+        double l01 = level(cell.az0, cell.el1);
+        double l11 = level(cell.az1, cell.el1);
+        return (1 - u) * (1 - v) * l00 + u * (1 - v) * l10 + (1 - u) * v * l01 + u * v * l11;
+    }
+
+    AdaptiveScanSettings m_settings;
+    std::vector<AdaptiveSample> m_samples;
+    std::map<Key, double> m_levels;
+    std::vector<Cell> m_cells;
+    size_t m_rootCount = 0;
+    bool m_complete = false;
+    double m_elapsedS = 0.0;
+};
+
+class AdaptiveScanner
+{
+public:
+    // The planner only orders the batches; without one the batches are
+    // measured in generation order
+    explicit AdaptiveScanner(const AdaptiveScanSettings &settings, const ScanPlanner *planner = nullptr)
+        : m_settings(settings)
+        , m_planner(planner)
+    {
+    }
+
+    // Runs the scan. Stops early (complete() == false) when the probe fails
+    // or maxPoints is reached; the result is still usable.
+    AdaptiveScanResult run(const AdaptiveProbe &probe, ScanAngle position = ScanAngle{0.0, 0.0, 0.0}) const
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        AdaptiveScanResult result;
+        result.m_settings = m_settings;
+        m_position = position;
+
+        // Coarse cells
+        std::vector<double> az = ScanGrid::range(m_settings.azMin, m_settings.azMax, m_settings.coarseStepDeg);
+        std::vector<double> el = ScanGrid::range(m_settings.elMin, m_settings.elMax,
+                                                 m_settings.elMax > m_settings.elMin ? m_settings.coarseStepDeg : 0.0);
+        if (m_settings.azMax - az.back() > 1e-9) az.push_back(m_settings.azMax);
+        if (m_settings.elMax - el.back() > 1e-9) el.push_back(m_settings.elMax);
+        size_t azCells = std::max<size_t>(1, az.size() - 1);
+        size_t elCells = std::max<size_t>(1, el.size() - 1);
+        for (size_t e = 0; e < elCells; e++) {
+            for (size_t a = 0; a < azCells; a++) {
+                AdaptiveScanResult::Cell cell;
+                cell.az0 = az[a];
+                cell.az1 = az.size() > 1 ? az[a + 1] : az[a];
+                cell.el0 = el[e];
+                cell.el1 = el.size() > 1 ? el[e + 1] : el[e];
+                cell.depth = 0;
+                cell.firstChild = -1;
+                cell.childCount = 0;
+                result.m_cells.push_back(cell);
+            }
+        }
+        result.m_rootCount = result.m_cells.size();
+
+        std::vector<ScanAngle> batch;
+        for (const auto &cell : result.m_cells) {
+            addCorners(result, cell, batch);
+        }
+        bool ok = measure(result, probe, batch, 0);
+
+        std::vector<int> active;
+        for (size_t i = 0; i < result.m_cells.size(); i++) {
+            active.push_back(static_cast<int>(i));
+        }
+
+        while (ok && !active.empty()) {
+            // Centers of cells that may still split (curvature test)
+            batch.clear();
+            double floorDb = strongestLevel(result) - m_settings.dynamicRangeDb;
+            for (int index : active) {
+                const auto &cell = result.m_cells[index];
+                if (splittable(cell) && (m_settings.dynamicRangeDb <= 0.0 || maxCorner(result, cell) >= floorDb)) {
+                    add(result, centerAz(cell), centerEl(cell), batch);
+                }
+            }
+            int depth = result.m_cells[active.front()].depth + 1;
+            ok = measure(result, probe, batch, depth);
+            if (!ok) {
+                break;
+            }
+
+            // Split the cells with the largest errors first, as far as the
+            // point budget allows (a split adds at most five points)
+            std::vector<std::pair<double, int>> candidates;
+            double peak = strongestLevel(result);
+            for (int index : active) {
+                const auto &cell = result.m_cells[index];
+                if (!splittable(cell)) {
+                    continue;
+                }
+                double error = refinementError(result, cell, peak);
+                if (error > 0.0) {
+                    candidates.push_back(std::make_pair(error, index));
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const std::pair<double, int> &a, const std::pair<double, int> &b) { return a.first > b.first; });
+
+            std::vector<int> next;
+            batch.clear();
+            for (const auto &candidate : candidates) {
+                if (result.m_samples.size() + batch.size() + 5 > m_settings.maxPoints) {
+                    ok = false;
+                    break;
+                }
+                int first = static_cast<int>(result.m_cells.size());
+                split(result, candidate.second);
+                for (int c = first; c < static_cast<int>(result.m_cells.size()); c++) {
+                    addCorners(result, result.m_cells[c], batch);
+                    next.push_back(c);
+                }
+            }
+            ok = measure(result, probe, batch, depth) && ok;
+            active.swap(next);
+        }
+
+        result.m_complete = ok;
+        result.m_elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+
+private:
+    static double centerAz(const AdaptiveScanResult::Cell &cell) { return 0.5 * (cell.az0 + cell.az1); }
+    static double centerEl(const AdaptiveScanResult::Cell &cell) { return 0.5 * (cell.el0 + cell.el1); }
+
+    bool splittable(const AdaptiveScanResult::Cell &cell) const
+    {
+        return (cell.az1 - cell.az0) > m_settings.minCellDeg || (cell.el1 - cell.el0) > m_settings.minCellDeg;
+    }
+
+    static double maxCorner(const AdaptiveScanResult &result, const AdaptiveScanResult::Cell &cell)
+    {
+        return std::max(std::max(result.level(cell.az0, cell.el0), result.level(cell.az1, cell.el0)),
+                        std::max(result.level(cell.az0, cell.el1), result.level(cell.az1, cell.el1)));
+    }
+
+    static double strongestLevel(const AdaptiveScanResult &result)
+    {
+        double peak = -std::numeric_limits<double>::infinity();
+        for (const auto &sample : result.m_samples) {
+            peak = std::max(peak, sample.levelDb);
+        }
+        return peak;
+    }
+
+    // How far the cell exceeds its tolerances, normalized to the
+    // tolerance (> 0 means split)
+    double refinementError(const AdaptiveScanResult &result, const AdaptiveScanResult::Cell &cell,
+                           double peakDb) const
+    {
+        double corners[4] = {
+            result.level(cell.az0, cell.el0), result.level(cell.az1, cell.el0),
+            result.level(cell.az0, cell.el1), result.level(cell.az1, cell.el1)
+        };
+        double lo = *std::min_element(corners, corners + 4);
+        double hi = *std::max_element(corners, corners + 4);
+        if (!result.has(centerAz(cell), centerEl(cell))) {
+            return 0.0;     // below the dynamic range when the centers were queued
+        }
+        double measured = result.level(centerAz(cell), centerEl(cell));
+        if (m_settings.dynamicRangeDb > 0.0 && std::max(hi, measured) < peakDb - m_settings.dynamicRangeDb) {
+            return 0.0;
+        }
+        // The main lobe top is always resolved down to minCellDeg
+        if (std::max(hi, measured) >= peakDb) {
+            return std::numeric_limits<double>::max();
+        }
+        double predicted = 0.25 * (corners[0] + corners[1] + corners[2] + corners[3]);
+        double gradient = m_settings.gradientDb > 0.0 ? (hi - lo) / m_settings.gradientDb : 0.0;
+        double curvature = m_settings.curvatureDb > 0.0 ? std::abs(measured - predicted) / m_settings.curvatureDb : 0.0;
+        double error = std::max(gradient, curvature);
+        return error > 1.0 ? error : 0.0;
+    }
+
+    // Halve the cell along every axis that is still larger than minCellDeg
+    void split(AdaptiveScanResult &result, int index) const
+    {
+        AdaptiveScanResult::Cell cell = result.m_cells[index];
+        bool splitAz = (cell.az1 - cell.az0) > m_settings.minCellDeg;
+        bool splitEl = (cell.el1 - cell.el0) > m_settings.minCellDeg;
+        double azEdges[3] = { cell.az0, splitAz ? centerAz(cell) : cell.az1, cell.az1 };
+        double elEdges[3] = { cell.el0, splitEl ? centerEl(cell) : cell.el1, cell.el1 };
+        int azParts = splitAz ? 2 : 1;
+        int elParts = splitEl ? 2 : 1;
+
+        result.m_cells[index].firstChild = static_cast<int>(result.m_cells.size());
+        result.m_cells[index].childCount = azParts * elParts;
+        for (int e = 0; e < elParts; e++) {
+            for (int a = 0; a < azParts; a++) {
+                AdaptiveScanResult::Cell child;
+                child.az0 = azEdges[a];
+                child.az1 = splitAz ? azEdges[a + 1] : cell.az1;
+                child.el0 = elEdges[e];
+                child.el1 = splitEl ? elEdges[e + 1] : cell.el1;
+                child.depth = cell.depth + 1;
+                child.firstChild = -1;
+                child.childCount = 0;
+                result.m_cells.push_back(child);
+            }
+        }
+    }
+
+    void addCorners(const AdaptiveScanResult &result, const AdaptiveScanResult::Cell &cell,
+                    std::vector<ScanAngle> &batch) const
+    {
+        add(result, cell.az0, cell.el0, batch);
+        add(result, cell.az1, cell.el0, batch);
+        add(result, cell.az0, cell.el1, batch);
+        add(result, cell.az1, cell.el1, batch);
+    }
+
+    // Queue an angle unless it is measured or already queued
+    void add(const AdaptiveScanResult &result, double az, double el, std::vector<ScanAngle> &batch) const
+    {
+        if (result.has(az, el)) {
+            return;
+        }
+        AdaptiveScanResult::Key k = AdaptiveScanResult::key(az, el);
+        for (const auto &queued : batch) {
+            if (AdaptiveScanResult::key(queued.az, queued.el) == k) {
+                return;
+            }
+        }
+        batch.push_back(ScanAngle{az, el, m_settings.pol});
+    }
+
+    bool measure(AdaptiveScanResult &result, const AdaptiveProbe &probe,
+                 std::vector<ScanAngle> batch, int depth) const
+    {
+        if (m_planner && batch.size() > 1) {
+            batch = m_planner->orderTour(batch, m_position);
+        }
+        for (const ScanAngle &angle : batch) {
+            if (result.m_samples.size() >= m_settings.maxPoints) {
+                return false;
+            }
+            double levelDb = 0.0;
+            if (!probe(angle, levelDb)) {
+                return false;
+            }
+            m_position = angle;
+            result.m_levels[AdaptiveScanResult::key(angle.az, angle.el)] = levelDb;
+            result.m_samples.push_back(AdaptiveSample{angle, levelDb, depth});
+        }
+        return true;
+    }
+
+    AdaptiveScanSettings m_settings;
+    const ScanPlanner *m_planner;
+    mutable ScanAngle m_position;
+};
+
+// Probe that moves a positioner, waits for onMovementStopped and reads the
+// peak level from a signal analyzer. Installs its own onMovementStopped and
+// onError handlers while alive and chains to the previous ones.
+class PositionerAnalyzerProbe
+{
+public:
+    PositionerAnalyzerProbe(IPositionerPlugin *positioner, ISignalAnalyzerPlugin *analyzer,
+                            std::chrono::milliseconds moveTimeout = std::chrono::seconds(120))
+        : m_positioner(positioner)
+        , m_analyzer(analyzer)
+        , m_moveTimeout(moveTimeout)
+        , m_stopped(false)
+        , m_failed(false)
+    {
+        m_previousStopped = m_positioner->onMovementStopped;
+        m_previousPositionerError = m_positioner->onError;
+        m_previousAnalyzerError = m_analyzer->onError;
+
+        m_positioner->onMovementStopped = [this]() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_cv.notify_all();
+            if (m_previousStopped) m_previousStopped();
+        };
+        m_positioner->onError = [this](const std::string &error) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_failed = true;
+            }
+            m_cv.notify_all();
+            if (m_previousPositionerError) m_previousPositionerError(error);
+        };
+        m_analyzer->onError = [this](const std::string &error) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_failed = true;
+            }
+            if (m_previousAnalyzerError) m_previousAnalyzerError(error);
+        };
+    }
+
+    ~PositionerAnalyzerProbe()
+    {
+        m_positioner->onMovementStopped = m_previousStopped;
+        m_positioner->onError = m_previousPositionerError;
+        m_analyzer->onError = m_previousAnalyzerError;
+    }
+
+    PositionerAnalyzerProbe(const PositionerAnalyzerProbe &) = delete;
+    PositionerAnalyzerProbe &operator=(const PositionerAnalyzerProbe &) = delete;
+
+    bool operator()(const ScanAngle &angle, double &levelDb)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = false;
+            m_failed = false;
+        }
+        m_positioner->moveTo(angle.az, angle.el, angle.pol);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_cv.wait_for(lock, m_moveTimeout, [this]() { return m_stopped || m_failed; }) || m_failed) {
+                return false;
+            }
+        }
+        Peak peak = m_analyzer->findPeak();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_failed) {
+            return false;
+        }
+        levelDb = peak.leveldBm;
+        return true;
+    }
+
+    // Adapter for AdaptiveScanner::run()
+    AdaptiveProbe probe()
+    {
+        return [this](const ScanAngle &angle, double &levelDb) { return (*this)(angle, levelDb); };
+    }
+
+private:
+    IPositionerPlugin *m_positioner;
+    ISignalAnalyzerPlugin *m_analyzer;
+    std::chrono::milliseconds m_moveTimeout;
+
+    std::function<void()> m_previousStopped;
+    std::function<void(const std::string&)> m_previousPositionerError;
+    std::function<void(const std::string&)> m_previousAnalyzerError;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopped;
+    bool m_failed;
+};
+
+#endif // ADAPTIVESCAN_H
@@ -0,0 +1,338 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef ARRAYFACTOR_H
+#define ARRAYFACTOR_H
+
+#include "common/simdkernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Phased-array pattern model.
+//
+// The array lies in the x-y plane (x horizontal, y vertical) and faces +z,
+// which is AZ = EL = 0 on the positioner. Direction (az, el) has the unit
+// vector (cos el sin az, sin el, cos el cos az). The gain is the element
+// gain times |AF|^2 / sum |a_n|^2, which is exact for uncoupled elements
+// on a lambda/2 lattice (N times the element gain at broadside for
+// uniform weights). Mutual coupling and grating-lobe gain loss are not
+// modeled.
+//
+// The array factor is evaluated two directions per SSE2 instruction with a
+// vectorized sincos, and large direction sets are split across threads.
+// Configure first, then evaluate; evaluation is const and may run from
+// several threads, configuration may not.
+
+struct ArrayElement {
+    double x;           // m
+    double y;           // m
+    double z;           // m
+    double amplitude;   // linear weight
+    double phaseDeg;    // excitation phase
+
+    ArrayElement() : x(0.0), y(0.0), z(0.0), amplitude(1.0), phaseDeg(0.0) {}
+    ArrayElement(double x, double y, double z = 0.0, double amplitude = 1.0, double phaseDeg = 0.0)
+        : x(x), y(y), z(z), amplitude(amplitude), phaseDeg(phaseDeg) {}
+};
+
+// Gain over a regular AZ/EL grid, interpolated bilinearly. Angles outside
+// the grid take the value at its edge.
+struct PatternGrid {
+    double azStartDeg;
+    double azStepDeg;
+    int azCount;
+    double elStartDeg;
+    double elStepDeg;
+    int elCount;
+    std::vector<double> gaindBi;    // [el * azCount + az]
+
+    PatternGrid() : azStartDeg(0.0), azStepDeg(1.0), azCount(0), elStartDeg(0.0), elStepDeg(1.0), elCount(0) {}
+
+    double at(double az, double el) const
+    {
+        if (azCount <= 0 || elCount <= 0) {
+            return 0.0;
+        }
+        double a = std::min(std::max((az - azStartDeg) / azStepDeg, 0.0), (double)(azCount - 1));
+        double e = std::min(std::max((el - elStartDeg) / elStepDeg, 0.0), (double)(elCount - 1));
+        int a0 = std::min((int)a, std::max(azCount - 2, 0));
+        int e0 = std::min((int)e, std::max(elCount - 2, 0));
+        int a1 = std::min(a0 + 1, azCount - 1);
+        int e1 = std::min(e0 + 1, elCount - 1);
+        double fa = a - a0;
+        double fe = e - e0;
+        double g0 = gaindBi[e0 * azCount + a0] * (1.0 - fa) + gaindBi[e0 * azCount + a1] * fa;
+        double g1 = gaindBi[e1 * azCount + a0] * (1.0 - fa) + gaindBi[e1 * azCount + a1] * fa;
+        return g0 * (1.0 - fe) + g1 * fe;
+    }
+};
+
+class ArrayFactor
+{
+public:
+    // Element gain in dBi towards (az, el)
+    typedef std::function<double(double az, double el)> ElementPattern;
+
+    // Element gain behind the array, relative to its peak
+    static constexpr double ElementBacklobedB = -30.0;
+    // Smallest share of directions worth a thread of its own
+    static constexpr size_t MinDirectionsPerThread = 512;
+
+    ArrayFactor()
+        : m_frequencyHz(5.5e9)
+        , m_cosineExponent(1.5)
+        , m_threadCount(std::max(1u, std::thread::hardware_concurrency()))
+        , m_weightNorm(0.0)
+    {
+    }
+
+    // columns x rows elements centered on the origin
+    static std::vector<ArrayElement> rectangularArray(int columns, int rows, double dxM, double dyM)
+    {
+        std::vector<ArrayElement> elements;
+        for (int row = 0; row < rows; row++) {
+            for (int column = 0; column < columns; column++) {
+                elements.push_back(ArrayElement((column - (columns - 1) / 2.0) * dxM, (row - (rows - 1) / 2.0) * dyM));
+            }
+        }
+        return elements;
+    }
+
+    void setElements(const std::vector<ArrayElement> &elements)
+    {
+        m_elements = elements;
+        update();
+    }
+
+    const std::vector<ArrayElement> &elements() const { return m_elements; }
+
+    void setFrequency(double frequencyHz)
+    {
+        m_frequencyHz = frequencyHz;
+        update();
+    }
+
+    // Sets every element phase so that the beam points to (az, el)
+    void steer(double az, double el)
+    {
+        double u, v, w;
+        direction(az, el, u, v, w);
+        double k = waveNumber();
+        for (ArrayElement &element : m_elements) {
+            double phase = -k * (element.x * u + element.y * v + element.z * w);
+            element.phaseDeg = std::remainder(phase * 180.0 / Pi, 360.0);
+        }
+        update();
+    }
+
+    // cos^q(theta) element (the default, q = 1.5), directivity 2 (q + 1)
+    void setCosineElement(double exponent)
+    {
+        m_cosineExponent = exponent;
+        m_elementPattern = nullptr;
+    }
+
+    void setElementPattern(const ElementPattern &pattern)
+    {
+        m_elementPattern = pattern;
+    }
+
+    void setThreadCount(unsigned int threads)
+    {
+        m_threadCount = std::max(1u, threads);
+    }
+
+    double gaindBi(double az, double el) const
+    {
+        double gain;
+        evaluateRange(&az, &el, &gain, 1);
+        return gain;
+    }
+
+    // gaindBi[i] for the directions (az[i], el[i])
+    void evaluate(const double *az, const double *el, double *gaindBi, size_t count) const
+    {
+        size_t threads = std::min<size_t>(m_threadCount, count / MinDirectionsPerThread);
+        if (threads <= 1) {
+            evaluateRange(az, el, gaindBi, count);
+            return;
+        }
+        size_t chunk = (count + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (size_t begin = chunk; begin < count; begin += chunk) {
+            size_t n = std::min(chunk, count - begin);
+            workers.emplace_back([=]() { evaluateRange(az + begin, el + begin, gaindBi + begin, n); });
+        }
+        evaluateRange(az, el, gaindBi, std::min(chunk, count));
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Pattern over az in [azMin, azMax] x el in [elMin, elMax]
+    PatternGrid grid(double azMin, double azMax, double azStep, double elMin, double elMax, double elStep) const
+    {
+        PatternGrid grid;
+        grid.azStartDeg = azMin;
+        grid.azStepDeg = azStep;
+        grid.azCount = (int)std::floor((azMax - azMin) / azStep + 1e-9) + 1;
+        grid.elStartDeg = elMin;
+        grid.elStepDeg = elStep;
+        grid.elCount = (int)std::floor((elMax - elMin) / elStep + 1e-9) + 1;
+
+        size_t count = (size_t)grid.azCount * (size_t)grid.elCount;
+        std::vector<double> az(count);
+        std::vector<double> el(count);
+        for (int e = 0; e < grid.elCount; e++) {
+            for (int a = 0; a < grid.azCount; a++) {
+                az[e * grid.azCount + a] = azMin + a * azStep;
+                el[e * grid.azCount + a] = elMin + e * elStep;
+            }
+        }
+        grid.gaindBi.resize(count);
+        evaluate(az.data(), el.data(), grid.gaindBi.data(), count);
+        return grid;
+    }
+
+private:
+    static constexpr double Pi = 3.14159265358979323846;
+
+    double waveNumber() const
+    {
+        return 2.0 * Pi * m_frequencyHz / 299792458.0;
+    }
+
+    static void direction(double az, double el, double &u, double &v, double &w)
+    {
+        double azRad = az * Pi / 180.0;
+        double elRad = el * Pi / 180.0;
+        u = std::cos(elRad) * std::sin(azRad);
+        v = std::sin(elRad);
+        w = std::cos(elRad) * std::cos(azRad);
+    }
+
+    // Element positions in radians per unit direction, and complex weights
+    void update()
+    {
+        double k = waveNumber();
+        size_t n = m_elements.size();
+        m_kx.resize(n);
+        m_ky.resize(n);
+        m_kz.resize(n);
+        m_weightRe.resize(n);
+        m_weightIm.resize(n);
+        m_weightNorm = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            const ArrayElement &element = m_elements[i];
+            m_kx[i] = k * element.x;
+            m_ky[i] = k * element.y;
+            m_kz[i] = k * element.z;
+            m_weightRe[i] = element.amplitude * std::cos(element.phaseDeg * Pi / 180.0);
+            m_weightIm[i] = element.amplitude * std::sin(element.phaseDeg * Pi / 180.0);
+            m_weightNorm += element.amplitude * element.amplitude;
+        }
+    }
+
+    double elementGaindBi(double az, double el, double w) const
+    {
+        if (m_elementPattern) {
+            return m_elementPattern(az, el);
+        }
+        double peakdBi = 10.0 * std::log10(2.0 * (m_cosineExponent + 1.0));
+        if (w <= std::pow(10.0, ElementBacklobedB / (10.0 * m_cosineExponent))) {
+            return peakdBi + ElementBacklobedB;
+        }
+        return peakdBi + 10.0 * m_cosineExponent * std::log10(w);
+    }
+
+    void evaluateRange(const double *az, const double *el, double *gaindBi, size_t count) const
+    {
+        const size_t n = m_elements.size();
+        const double invNorm = m_weightNorm > 0.0 ? 1.0 / m_weightNorm : 0.0;
+        size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+        for (; i + 2 <= count; i += 2) {
+            double u[2], v[2], w[2];
+            direction(az[i], el[i], u[0], v[0], w[0]);
+            direction(az[i + 1], el[i + 1], u[1], v[1], w[1]);
+            __m128d vu = _mm_loadu_pd(u);
+            __m128d vv = _mm_loadu_pd(v);
+            __m128d vw = _mm_loadu_pd(w);
+            __m128d re = _mm_setzero_pd();
+            __m128d im = _mm_setzero_pd();
+            for (size_t k = 0; k < n; k++) {
+                __m128d phase = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(m_kx[k]), vu),
+                                                      _mm_mul_pd(_mm_set1_pd(m_ky[k]), vv)),
+                                           _mm_mul_pd(_mm_set1_pd(m_kz[k]), vw));
+                __m128d s, c;
+                SimdKernels::sinCosPd(phase, s, c);
+                __m128d wRe = _mm_set1_pd(m_weightRe[k]);
+                __m128d wIm = _mm_set1_pd(m_weightIm[k]);
+                re = _mm_add_pd(re, _mm_sub_pd(_mm_mul_pd(wRe, c), _mm_mul_pd(wIm, s)));
+                im = _mm_add_pd(im, _mm_add_pd(_mm_mul_pd(wRe, s), _mm_mul_pd(wIm, c)));
+            }
+            __m128d power = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(re, re), _mm_mul_pd(im, im)), _mm_set1_pd(invNorm));
+            _mm_storeu_pd(gaindBi + i, power);
+            SimdKernels::linearToDb(gaindBi + i, gaindBi + i, 2);
+            gaindBi[i] += elementGaindBi(az[i], el[i], w[0]);
+            gaindBi[i + 1] += elementGaindBi(az[i + 1], el[i + 1], w[1]);
+        }
+#endif
+        for (; i < count; i++) {
+            double u, v, w;
+            direction(az[i], el[i], u, v, w);
+            double re = 0.0;
+            double im = 0.0;
+            for (size_t k = 0; k < n; k++) {
+                double phase = m_kx[k] * u + m_ky[k] * v + m_kz[k] * w;
+                double s = std::sin(phase);
+                double c = std::cos(phase);
+                re += m_weightRe[k] * c - m_weightIm[k] * s;
+                im += m_weightRe[k] * s + m_weightIm[k] * c;
+            }
+            double power = (re * re + im * im) * invNorm;
+            SimdKernels::linearToDb(&power, gaindBi + i, 1);
+            gaindBi[i] += elementGaindBi(az[i], el[i], w);
+        }
+    }
+
+    std::vector<ArrayElement> m_elements;
+    double m_frequencyHz;
+    double m_cosineExponent;
+    ElementPattern m_elementPattern;
+    unsigned int m_threadCount;
+
+    // Derived from the elements by update()
+    std::vector<double> m_kx;
+    std::vector<double> m_ky;
+    std::vector<double> m_kz;
+    std::vector<double> m_weightRe;
+    std::vector<double> m_weightIm;
+    double m_weightNorm;
+};
+
+#endif // ARRAYFACTOR_H
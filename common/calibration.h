@@ -0,0 +1,658 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include "iplugininterface.h"
+#include "common/simdkernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Frequency-dependent level corrections (cable loss, amplifier gain,
+// reference antenna gain/factor).
+//
+// Tables are loaded from CSV files ("frequency_hz,correction_db" per line,
+// '#' comments and a non-numeric header line are skipped) and combined
+// into an immutable CalibrationSet, which is published through a
+// Calibration object. Replacing the set is a single atomic pointer swap,
+// so tables can be reloaded while a scan is running; every trace or
+// setpoint is corrected with either the old or the new set, never a mix.
+//
+// Sign convention:
+//   - Receive path: corrected level = measured level + correction
+//     (cable loss +, preamplifier gain -, antenna gain -)
+//   - Transmit path: generator setpoint = wanted level + correction
+//     (cable loss +, amplifier gain -)
+//
+// Usage:
+//     Calibration calibration;
+//     CalibrationSet set;
+//     std::string error;
+//     CalibrationTable cable;
+//     if (cable.loadCsv("rx_cable.csv", error)) set.add(CalibrationPath::Receive, cable, +1.0);
+//     calibration.publish(set);
+//
+//     CalibratedSignalAnalyzer sa(rawAnalyzer, calibration);
+
+enum class CalibrationPath {
+    Receive,
+    Transmit
+};
+
+class CalibrationTable
+{
+public:
+    struct Point {
+        double freqHz;
+        double valueDb;
+    };
+
+    CalibrationTable() = default;
+
+    explicit CalibrationTable(const std::string &name)
+        : m_name(name)
+    {
+    }
+
+    const std::string &name() const { return m_name; }
+    const std::vector<Point> &points() const { return m_points; }
+    bool isEmpty() const { return m_points.empty(); }
+
+    // Points may be added in any order
+    void addPoint(double freqHz, double valueDb)
+    {
+        Point point = { freqHz, valueDb };
+        auto it = std::lower_bound(m_points.begin(), m_points.end(), point,
+                                   [](const Point &a, const Point &b) { return a.freqHz < b.freqHz; });
+        if (it != m_points.end() && it->freqHz == freqHz) {
+            it->valueDb = valueDb;
+        } else {
+            m_points.insert(it, point);
+        }
+    }
+
+    bool loadCsv(const std::string &path, std::string &error)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "Cannot open calibration file " + path;
+            return false;
+        }
+        std::vector<Point> loaded;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            std::replace(line.begin(), line.end(), ';', ',');
+            size_t comma = line.find(',');
+            const char *text = line.c_str();
+            char *end = nullptr;
+            double freq = std::strtod(text, &end);
+            bool ok = comma != std::string::npos && end != text;
+            double value = 0.0;
+            if (ok) {
+                const char *valueText = text + comma + 1;
+                value = std::strtod(valueText, &end);
+                ok = end != valueText;
+            }
+            if (!ok) {
+                // Header line
+                if (loaded.empty()) {
+                    continue;
+                }
+                error = path + ":" + std::to_string(lineNumber) + ": expected frequency_hz,correction_db";
+                return false;
+            }
+            loaded.push_back(Point{ freq, value });
+        }
+        if (loaded.empty()) {
+            error = "No calibration points in " + path;
+            return false;
+        }
+        if (m_name.empty()) {
+            m_name = path;
+        }
+        m_points.clear();
+        for (const Point &point : loaded) {
+            addPoint(point.freqHz, point.valueDb);
+        }
+        return true;
+    }
+
+    // Linear interpolation, constant beyond the first and last point
+    double valueAt(double freqHz) const
+    {
+        if (m_points.empty()) {
+            return 0.0;
+        }
+        if (freqHz <= m_points.front().freqHz) {
+            return m_points.front().valueDb;
+        }
+        if (freqHz >= m_points.back().freqHz) {
+            return m_points.back().valueDb;
+        }
+        Point key = { freqHz, 0.0 };
+        auto hi = std::upper_bound(m_points.begin(), m_points.end(), key,
+                                   [](const Point &a, const Point &b) { return a.freqHz < b.freqHz; });
+        auto lo = hi - 1;
+        double t = (freqHz - lo->freqHz) / (hi->freqHz - lo->freqHz);
+        return lo->valueDb + t * (hi->valueDb - lo->valueDb);
+    }
+
+    // Values on an equally spaced grid in one pass over the table
+    void resample(double startHz, double stopHz, size_t count, double scale, double *out) const
+    {
+        if (count == 0) {
+            return;
+        }
+        double stepHz = count > 1 ? (stopHz - startHz) / static_cast<double>(count - 1) : 0.0;
+        if (m_points.empty()) {
+            std::fill(out, out + count, 0.0);
+            return;
+        }
+        size_t segment = 0;
+        for (size_t i = 0; i < count; i++) {
+            double freq = startHz + stepHz * static_cast<double>(i);
+            if (stepHz < 0.0) {
+                out[i] = scale * valueAt(freq);
+                continue;
+            }
+            if (freq <= m_points.front().freqHz) {
+                out[i] = scale * m_points.front().valueDb;
+            } else if (freq >= m_points.back().freqHz) {
+                out[i] = scale * m_points.back().valueDb;
+            } else {
+                while (m_points[segment + 1].freqHz < freq) {
+                    segment++;
+                }
+                const Point &lo = m_points[segment];
+                const Point &hi = m_points[segment + 1];
+                double t = (freq - lo.freqHz) / (hi.freqHz - lo.freqHz);
+                out[i] = scale * (lo.valueDb + t * (hi.valueDb - lo.valueDb));
+            }
+        }
+    }
+
+private:
+    std::string m_name;
+    std::vector<Point> m_points;
+};
+
+// Immutable once published
+class CalibrationSet
+{
+public:
+    struct Entry {
+        CalibrationPath path;
+        CalibrationTable table;
+        double scale;       // +1 for losses, -1 for gains
+    };
+
+    void add(CalibrationPath path, const CalibrationTable &table, double scale)
+    {
+        m_entries.push_back(Entry{ path, table, scale });
+    }
+
+    const std::vector<Entry> &entries() const { return m_entries; }
+
+    double correctionAt(CalibrationPath path, double freqHz) const
+    {
+        double total = 0.0;
+        for (const Entry &entry : m_entries) {
+            if (entry.path == path) {
+                total += entry.scale * entry.table.valueAt(freqHz);
+            }
+        }
+        return total;
+    }
+
+    // Total correction on an equally spaced grid
+    void resample(CalibrationPath path, double startHz, double stopHz, size_t count,
+                  std::vector<double> &out) const
+    {
+        out.assign(count, 0.0);
+        std::vector<double> part(count);
+        for (const Entry &entry : m_entries) {
+            if (entry.path != path) {
+                continue;
+            }
+            entry.table.resample(startHz, stopHz, count, entry.scale, part.data());
+            SimdKernels::addArrays(out.data(), part.data(), out.data(), count);
+        }
+    }
+
+private:
+    std::vector<Entry> m_entries;
+};
+
+// Correction LUT resampled for one sweep grid
+struct CalibrationLut {
+    uint64_t version = 0;
+    double startFreqHz = 0.0;
+    double stopFreqHz = 0.0;
+    std::vector<double> correctionDb;
+
+    bool matches(uint64_t setVersion, const Trace &trace) const
+    {
+        return version == setVersion && startFreqHz == trace.startFreqHz &&
+               stopFreqHz == trace.stopFreqHz && correctionDb.size() == trace.levelsdBm.size();
+    }
+};
+
+class Calibration
+{
+public:
+    Calibration()
+        : m_current(std::make_shared<Snapshot>())
+        , m_version(1)
+    {
+    }
+
+    // Replace the active set; safe while other threads apply corrections
+    void publish(const CalibrationSet &set)
+    {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>();
+        next->set = set;
+        next->version = m_version.load() + 1;
+        std::atomic_store(&m_current, std::shared_ptr<const Snapshot>(next));
+        m_version.store(next->version);
+    }
+
+    void clear()
+    {
+        publish(CalibrationSet());
+    }
+
+    uint64_t version() const { return m_version.load(std::memory_order_acquire); }
+
+    // Keeps the returned set alive even if it is replaced meanwhile
+    std::shared_ptr<const CalibrationSet> set() const
+    {
+        std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&m_current);
+        return std::shared_ptr<const CalibrationSet>(snapshot, &snapshot->set);
+    }
+
+    double correctionAt(CalibrationPath path, double freqHz) const
+    {
+        return std::atomic_load(&m_current)->set.correctionAt(path, freqHz);
+    }
+
+    // Rebuilds the LUT only when the set or the grid changed
+    void updateLut(CalibrationPath path, const Trace &trace, CalibrationLut &lut) const
+    {
+        if (lut.matches(version(), trace)) {
+            return;
+        }
+        std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&m_current);
+        snapshot->set.resample(path, trace.startFreqHz, trace.stopFreqHz, trace.levelsdBm.size(),
+                               lut.correctionDb);
+        lut.version = snapshot->version;
+        lut.startFreqHz = trace.startFreqHz;
+        lut.stopFreqHz = trace.stopFreqHz;
+    }
+
+    // Corrects a trace in place (receive path). The LUT belongs to the
+    // caller (one per thread) and is reused while the grid is unchanged.
+    void applyToTrace(Trace &trace, CalibrationLut &lut) const
+    {
+        updateLut(CalibrationPath::Receive, trace, lut);
+        SimdKernels::addArrays(trace.levelsdBm.data(), lut.correctionDb.data(),
+                               trace.levelsdBm.data(), trace.levelsdBm.size());
+    }
+
+    void applyToPeak(Peak &peak) const
+    {
+        peak.leveldBm += correctionAt(CalibrationPath::Receive, peak.frequencyHz);
+    }
+
+    void applyToZeroSpan(ZeroSpanCapture &capture) const
+    {
+        double correctionDb = correctionAt(CalibrationPath::Receive, capture.centerFreqHz);
+        for (double &level : capture.levelsdBm) {
+            level += correctionDb;
+        }
+    }
+
+    // Generator setpoint that gives powerDbm at the reference plane
+    double setpointFor(double powerDbm, double freqHz) const
+    {
+        return powerDbm + correctionAt(CalibrationPath::Transmit, freqHz);
+    }
+
+private:
+    struct Snapshot {
+        CalibrationSet set;
+        uint64_t version = 1;
+    };
+
+    std::shared_ptr<const Snapshot> m_current;
+    std::atomic<uint64_t> m_version;
+    std::mutex m_publishMutex;
+};
+
+// Analyzer decorator that corrects peaks and traces on the receive path
+class CalibratedSignalAnalyzer : public ISignalAnalyzerPlugin
+{
+public:
+    CalibratedSignalAnalyzer(ISignalAnalyzerPlugin *plugin, const Calibration &calibration)
+        : m_plugin(plugin)
+        , m_calibration(calibration)
+    {
+        m_plugin->onConnected = [this]() { if (onConnected) onConnected(); };
+        m_plugin->onDisconnected = [this]() { if (onDisconnected) onDisconnected(); };
+        m_plugin->onPeakFound = [this](const Peak &peak) {
+            if (!onPeakFound) return;
+            Peak corrected = peak;
+            m_calibration.applyToPeak(corrected);
+            onPeakFound(corrected);
+        };
+        m_plugin->onError = [this](const std::string &error) { if (onError) onError(error); };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+    }
+
+    ~CalibratedSignalAnalyzer() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onPeakFound = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+    }
+
+    ISignalAnalyzerPlugin *plugin() const { return m_plugin; }
+
+    std::vector<DeviceInfo> scanDevices() override { return m_plugin->scanDevices(); }
+    bool connectToDevice(const std::string &address) override { return m_plugin->connectToDevice(address); }
+    bool connect() override { return m_plugin->connect(); }
+    void disconnect() override { m_plugin->disconnect(); }
+    bool isConnected() const override { return m_plugin->isConnected(); }
+    void setStartFreq(double freqHz) override { m_plugin->setStartFreq(freqHz); }
+    void setStopFreq(double freqHz) override { m_plugin->setStopFreq(freqHz); }
+    void setRBW(double freqHz) override { m_plugin->setRBW(freqHz); }
+
+    Peak findPeak() override
+    {
+        Peak peak = m_plugin->findPeak();
+        m_calibration.applyToPeak(peak);
+        return peak;
+    }
+
+    Peak findPeakFast(double targetAccuracyHz) override
+    {
+        Peak peak = m_plugin->findPeakFast(targetAccuracyHz);
+        m_calibration.applyToPeak(peak);
+        return peak;
+    }
+
+    // Not reentrant: one thread reads traces through a decorator
+    bool readTrace(Trace &trace) override
+    {
+        if (!m_plugin->readTrace(trace)) {
+            return false;
+        }
+        m_calibration.applyToTrace(trace, m_lut);
+        return true;
+    }
+
+    bool captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                         ZeroSpanCapture &capture) override
+    {
+        if (!m_plugin->captureZeroSpan(centerFreqHz, rbwHz, sampleRateHz, durationS, capture)) {
+            return false;
+        }
+        m_calibration.applyToZeroSpan(capture);
+        return true;
+    }
+
+    uint64_t timestampClockNs() override { return m_plugin->timestampClockNs(); }
+    bool setTriggerIn(TriggerInMode mode, double timeoutS) override { return m_plugin->setTriggerIn(mode, timeoutS); }
+
+private:
+    ISignalAnalyzerPlugin *m_plugin;
+    const Calibration &m_calibration;
+    CalibrationLut m_lut;
+};
+
+// Generator decorator that turns setPower() into the setpoint giving that
+// power at the reference plane, and re-applies it when the frequency
+// changes. Published tables take effect at the next setFreq()/setPower().
+class CalibratedSignalGenerator : public ISignalGeneratorPlugin
+{
+public:
+    CalibratedSignalGenerator(ISignalGeneratorPlugin *plugin, const Calibration &calibration)
+        : m_plugin(plugin)
+        , m_calibration(calibration)
+        , m_freqHz(0.0)
+        , m_powerDbm(0.0)
+        , m_hasFreq(false)
+        , m_hasPower(false)
+        , m_setpointDbm(0.0)
+        , m_hasSetpoint(false)
+        , m_hopSetpointsVersion(0)
+        , m_hopSetpointsPowerDbm(0.0)
+        , m_hopSetpointsValid(false)
+    {
+        m_plugin->onConnected = [this]() { if (onConnected) onConnected(); };
+        m_plugin->onDisconnected = [this]() { if (onDisconnected) onDisconnected(); };
+        m_plugin->onRfEnabled = [this]() { if (onRfEnabled) onRfEnabled(); };
+        m_plugin->onRfDisabled = [this]() { if (onRfDisabled) onRfDisabled(); };
+        m_plugin->onError = [this](const std::string &error) { if (onError) onError(error); };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+        m_plugin->onFreqSettled = [this](double freqHz, double lockTimeUs) {
+            if (onFreqSettled) onFreqSettled(freqHz, lockTimeUs);
+        };
+    }
+
+    ~CalibratedSignalGenerator() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onRfEnabled = nullptr;
+        m_plugin->onRfDisabled = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+        m_plugin->onFreqSettled = nullptr;
+    }
+
+    ISignalGeneratorPlugin *plugin() const { return m_plugin; }
+
+    std::vector<DeviceInfo> scanDevices() override { return m_plugin->scanDevices(); }
+    // The device level is unknown after a (re)connect
+    bool connectToDevice(const std::string &address) override
+    {
+        m_hasSetpoint = false;
+        return m_plugin->connectToDevice(address);
+    }
+    bool connect() override
+    {
+        m_hasSetpoint = false;
+        return m_plugin->connect();
+    }
+    void disconnect() override { m_plugin->disconnect(); }
+    bool isConnected() const override { return m_plugin->isConnected(); }
+
+    void setFreq(double freqHz) override
+    {
+        m_plugin->setFreq(freqHz);
+        m_freqHz = freqHz;
+        m_hasFreq = true;
+        if (m_hasPower) {
+            sendSetpoint(m_calibration.setpointFor(m_powerDbm, m_freqHz));
+        }
+    }
+
+    // Without a known frequency the power is passed through uncorrected
+    void setPower(double powerDbm) override
+    {
+        m_powerDbm = powerDbm;
+        m_hasPower = true;
+        sendSetpoint(m_hasFreq ? m_calibration.setpointFor(powerDbm, m_freqHz) : powerDbm);
+    }
+
+    // The level at the reference plane, as passed to setPower()
+    bool getPower(double &powerDbm) const override
+    {
+        if (!m_hasPower) {
+            return false;
+        }
+        powerDbm = m_powerDbm;
+        return true;
+    }
+
+    void enableRf() override { m_plugin->enableRf(); }
+    void disableRf() override { m_plugin->disableRf(); }
+    bool isRfEnabled() const override { return m_plugin->isRfEnabled(); }
+    bool setSettledMode(bool enabled, double timeoutMs) override { return m_plugin->setSettledMode(enabled, timeoutMs); }
+
+    // Only channel 0 is corrected; other channels pass through
+    int channelCount() const override { return m_plugin->channelCount(); }
+    bool channelInfo(int channel, ChannelInfo &info) const override { return m_plugin->channelInfo(channel, info); }
+
+    bool setChannelFreq(int channel, double freqHz) override
+    {
+        if (channel == 0) {
+            setFreq(freqHz);
+            return true;
+        }
+        return m_plugin->setChannelFreq(channel, freqHz);
+    }
+
+    bool setChannelPower(int channel, double powerDbm) override
+    {
+        if (channel == 0) {
+            setPower(powerDbm);
+            return true;
+        }
+        return m_plugin->setChannelPower(channel, powerDbm);
+    }
+
+    bool setChannelRfEnabled(int channel, bool enabled) override { return m_plugin->setChannelRfEnabled(channel, enabled); }
+    bool isChannelRfEnabled(int channel) const override { return m_plugin->isChannelRfEnabled(channel); }
+
+    // Hops keep the power correct at the reference plane. The setpoint of
+    // every entry is precomputed, and setPower() is only called on a hop
+    // whose setpoint differs from the one the device already has.
+    bool loadHopTable(const std::vector<double> &freqsHz) override
+    {
+        if (!m_plugin->loadHopTable(freqsHz)) {
+            return false;
+        }
+        m_hopTable = freqsHz;
+        m_hopSetpointsValid = false;
+        updateHopSetpoints();
+        return true;
+    }
+
+    bool hopTo(size_t index) override
+    {
+        if (index >= m_hopTable.size() || !m_plugin->hopTo(index)) {
+            return false;
+        }
+        m_freqHz = m_hopTable[index];
+        m_hasFreq = true;
+        if (m_hasPower) {
+            updateHopSetpoints();
+            double setpointDbm = m_hopSetpoints[index];
+            if (!m_hasSetpoint || setpointDbm != m_setpointDbm) {
+                sendSetpoint(setpointDbm);
+            }
+        }
+        return true;
+    }
+
+    bool setHopVerification(bool enabled) override { return m_plugin->setHopVerification(enabled); }
+
+    // List sweeps run in hardware at the current setpoint; the power is not
+    // corrected per list point
+    bool loadFreqList(const std::vector<double> &freqsHz) override { return m_plugin->loadFreqList(freqsHz); }
+    bool startFreqList(double dwellS, unsigned int cycles) override { return m_plugin->startFreqList(dwellS, cycles); }
+    bool stopFreqList() override { return m_plugin->stopFreqList(); }
+    bool announceIdle(double idleS) override { return m_plugin->announceIdle(idleS); }
+    bool setTriggerOut(TriggerOutMode mode) override { return m_plugin->setTriggerOut(mode); }
+    bool setTriggerIn(TriggerInMode mode) override { return m_plugin->setTriggerIn(mode); }
+
+private:
+    void sendSetpoint(double setpointDbm)
+    {
+        m_plugin->setPower(setpointDbm);
+        m_setpointDbm = setpointDbm;
+        m_hasSetpoint = true;
+    }
+
+    // Recomputes the hop setpoints when the power, the table or the
+    // published calibration changed
+    void updateHopSetpoints()
+    {
+        if (!m_hasPower) {
+            return;
+        }
+        uint64_t version = m_calibration.version();
+        if (m_hopSetpointsValid && m_hopSetpointsVersion == version && m_hopSetpointsPowerDbm == m_powerDbm) {
+            return;
+        }
+        m_hopSetpoints.resize(m_hopTable.size());
+        for (size_t i = 0; i < m_hopTable.size(); i++) {
+            m_hopSetpoints[i] = m_calibration.setpointFor(m_powerDbm, m_hopTable[i]);
+        }
+        m_hopSetpointsVersion = version;
+        m_hopSetpointsPowerDbm = m_powerDbm;
+        m_hopSetpointsValid = true;
+    }
+
+    ISignalGeneratorPlugin *m_plugin;
+    const Calibration &m_calibration;
+    double m_freqHz;
+    double m_powerDbm;
+    bool m_hasFreq;
+    bool m_hasPower;
+    double m_setpointDbm;       // last level sent to the plugin
+    bool m_hasSetpoint;
+    std::vector<double> m_hopTable;
+    std::vector<double> m_hopSetpoints;
+    uint64_t m_hopSetpointsVersion;
+    double m_hopSetpointsPowerDbm;
+    bool m_hopSetpointsValid;
+};
+
+#endif // CALIBRATION_H
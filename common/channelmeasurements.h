@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef CHANNELMEASUREMENTS_H
+#define CHANNELMEASUREMENTS_H
+
+#include "iplugininterface.h"
+#include "common/simdkernels.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Integrated power measurements on one analyzer trace: channel power,
+// occupied bandwidth and adjacent-channel power ratio.
+//
+// The trace is converted to linear power once (vectorized, see
+// common/simdkernels.h) and summed into a prefix array, so every channel
+// afterwards costs O(1) and any number of channels come out of one sweep.
+// Trace point i stands for the bin of width delta = span / (points - 1)
+// centered on its frequency, and channel edges cut bins fractionally.
+// Each point reads the power in the RBW filter, so the sum is scaled by
+// delta / ENBW, with the noise bandwidth of a Gaussian RBW filter
+// (1.065 RBW). Results are meaningful for traces with an RMS or sample
+// detector and a point spacing no wider than the RBW.
+
+struct AcprResult {
+    bool complete;                  // every channel lies inside the trace
+    double mainChanneldBm;
+    std::vector<double> lowerdBm;   // adjacent pair k at index k - 1
+    std::vector<double> upperdBm;
+    std::vector<double> lowerdBc;
+    std::vector<double> upperdBc;
+
+    AcprResult() : complete(false), mainChanneldBm(0.0) {}
+};
+
+class ChannelPowerMeter
+{
+public:
+    static constexpr double GaussianNoiseBandwidth = 1.065;    // ENBW / RBW
+
+    explicit ChannelPowerMeter(const Trace &trace)
+    {
+        setTrace(trace);
+    }
+
+    // Reuses the buffers of the previous trace
+    void setTrace(const Trace &trace)
+    {
+        size_t points = trace.levelsdBm.size();
+        m_startFreqHz = trace.startFreqHz;
+        m_binHz = points > 1 ? (trace.stopFreqHz - trace.startFreqHz) / (double)(points - 1) : 0.0;
+        double noiseBandwidthHz = GaussianNoiseBandwidth * trace.rbwHz;
+        m_scale = noiseBandwidthHz > 0.0 ? m_binHz / noiseBandwidthHz : 1.0;
+
+        m_linear.resize(points);
+        SimdKernels::dbToLinear(trace.levelsdBm.data(), m_linear.data(), points);
+        m_prefix.resize(points + 1);
+        m_prefix[0] = 0.0;
+        for (size_t i = 0; i < points; i++) {
+            m_prefix[i + 1] = m_prefix[i] + m_linear[i];
+        }
+    }
+
+    size_t points() const { return m_linear.size(); }
+
+    // Lower and upper edge of the bins the trace covers
+    double lowerEdgeHz() const { return m_startFreqHz - m_binHz / 2.0; }
+    double upperEdgeHz() const { return m_startFreqHz + (points() - 0.5) * m_binHz; }
+
+    bool covers(double lowHz, double highHz) const
+    {
+        return points() > 1 && lowHz >= lowerEdgeHz() && highHz <= upperEdgeHz();
+    }
+
+    // Power in mW between two frequencies, clipped to the trace
+    double powermW(double lowHz, double highHz) const
+    {
+        if (points() < 2 || highHz <= lowHz) {
+            return 0.0;
+        }
+        return (cumulative(position(highHz)) - cumulative(position(lowHz))) * m_scale;
+    }
+
+    double channelPowerdBm(double centerHz, double bandwidthHz) const
+    {
+        return toDbm(powermW(centerHz - bandwidthHz / 2.0, centerHz + bandwidthHz / 2.0));
+    }
+
+    // Several channels of the same bandwidth from the one trace
+    void channelPowersdBm(const std::vector<double> &centersHz, double bandwidthHz, std::vector<double> &powersdBm) const
+    {
+        powersdBm.resize(centersHz.size());
+        for (size_t i = 0; i < centersHz.size(); i++) {
+            powersdBm[i] = channelPowerdBm(centersHz[i], bandwidthHz);
+        }
+    }
+
+    // Bandwidth holding percent of the power between lowHz and highHz,
+    // with (100 - percent) / 2 outside on either side. The edges are
+    // returned in obwLowHz and obwHighHz. Returns false without power.
+    bool occupiedBandwidth(double lowHz, double highHz, double percent, double &obwLowHz, double &obwHighHz) const
+    {
+        if (points() < 2 || highHz <= lowHz) {
+            return false;
+        }
+        double x0 = position(lowHz);
+        double x1 = position(highHz);
+        double c0 = cumulative(x0);
+        double total = cumulative(x1) - c0;
+        if (!(total > 0.0)) {
+            return false;
+        }
+        double outside = total * (1.0 - std::min(std::max(percent, 0.0), 100.0) / 100.0) / 2.0;
+        obwLowHz = frequency(inverse(c0 + outside, x0, x1));
+        obwHighHz = frequency(inverse(c0 + total - outside, x0, x1));
+        return true;
+    }
+
+    // Main channel and pairs of adjacent channels at multiples of
+    // spacingHz, all from the one trace
+    AcprResult acpr(double centerHz, double channelBandwidthHz, double spacingHz, double adjacentBandwidthHz,
+                    int pairs) const
+    {
+        AcprResult result;
+        result.mainChanneldBm = channelPowerdBm(centerHz, channelBandwidthHz);
+        result.complete = covers(centerHz - channelBandwidthHz / 2.0, centerHz + channelBandwidthHz / 2.0);
+        for (int k = 1; k <= pairs; k++) {
+            double lower = centerHz - k * spacingHz;
+            double upper = centerHz + k * spacingHz;
+            result.lowerdBm.push_back(channelPowerdBm(lower, adjacentBandwidthHz));
+            result.upperdBm.push_back(channelPowerdBm(upper, adjacentBandwidthHz));
+            result.lowerdBc.push_back(result.lowerdBm.back() - result.mainChanneldBm);
+            result.upperdBc.push_back(result.upperdBm.back() - result.mainChanneldBm);
+            result.complete = result.complete && covers(lower - adjacentBandwidthHz / 2.0, lower + adjacentBandwidthHz / 2.0) &&
+                              covers(upper - adjacentBandwidthHz / 2.0, upper + adjacentBandwidthHz / 2.0);
+        }
+        return result;
+    }
+
+private:
+    static double toDbm(double powermW)
+    {
+        double dBm;
+        SimdKernels::linearToDb(&powermW, &dBm, 1);
+        return dBm;
+    }
+
+    // Bin coordinate: bin i covers [i, i + 1), clipped to the trace
+    double position(double freqHz) const
+    {
+        double x = (freqHz - m_startFreqHz) / m_binHz + 0.5;
+        return std::min(std::max(x, 0.0), (double)points());
+    }
+
+    double frequency(double x) const
+    {
+        return m_startFreqHz + (x - 0.5) * m_binHz;
+    }
+
+    // Sum of the bins below x, the bin containing x taken pro rata
+    double cumulative(double x) const
+    {
+        size_t i = std::min((size_t)x, points() - 1);
+        return m_prefix[i] + (x - (double)i) * m_linear[i];
+    }
+
+    // Position in [x0, x1] where the cumulative power reaches target
+    double inverse(double target, double x0, double x1) const
+    {
+        size_t first = std::min((size_t)x0, points() - 1);
+        size_t last = std::min((size_t)x1, points() - 1);
+        // First bin whose upper edge reaches the target
+        size_t i = std::lower_bound(m_prefix.begin() + first + 1, m_prefix.begin() + last + 1, target) - m_prefix.begin();
+        i = std::min(i, last + 1) - 1;
+        double x = m_linear[i] > 0.0 ? (double)i + (target - m_prefix[i]) / m_linear[i] : (double)i;
+        return std::min(std::max(x, x0), x1);
+    }
+
+    double m_startFreqHz;
+    double m_binHz;
+    double m_scale;
+    std::vector<double> m_linear;
+    std::vector<double> m_prefix;
+};
+
+#endif // CHANNELMEASUREMENTS_H
@@ -0,0 +1,280 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include "iplugininterface.h"
+#include "common/latencyhistogram.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Clock alignment of plugin timestamps (Peak, Trace, PositionSample).
+//
+// ClockSync estimates how a plugin's timestamp clock relates to the host
+// steady clock. Each exchange reads the host clock, the plugin clock
+// (timestampClockNs()) and the host clock again; the plugin reading is
+// taken to fall at the midpoint, within half the round trip. Of the last
+// WindowSize exchanges, the quarter with the shortest round trips is fit
+// with a line, giving the offset and drift of the plugin clock. Plugins
+// that stamp with steadyClockNs() come out at offset ~0 and drift 0.
+//
+// addEvent() records how late callbacks arrive after the event they
+// report, which bounds how stale a reading is when it is handled.
+//
+// PositionHistory keeps the recent positioner samples so a measurement
+// taken during motion can be paired with the angle at its timestamp.
+
+class ClockSync
+{
+public:
+    static constexpr size_t WindowSize = 64;
+
+    ClockSync()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exchanges.clear();
+        m_offsetNs = 0.0;
+        m_drift = 0.0;
+        m_referenceNs = 0;
+        m_uncertaintyNs = 0;
+        m_eventLatency.reset();
+    }
+
+    // hostSendNs <= hostReceiveNs, both from steadyClockNs()
+    void addExchange(uint64_t hostSendNs, uint64_t remoteNs, uint64_t hostReceiveNs)
+    {
+        if (hostReceiveNs < hostSendNs) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Exchange exchange;
+        exchange.hostNs = hostSendNs + (hostReceiveNs - hostSendNs) / 2;
+        exchange.offsetNs = static_cast<double>(static_cast<int64_t>(remoteNs - exchange.hostNs));
+        exchange.roundTripNs = hostReceiveNs - hostSendNs;
+        m_exchanges.push_back(exchange);
+        if (m_exchanges.size() > WindowSize) {
+            m_exchanges.pop_front();
+        }
+        fit();
+    }
+
+    // Runs a burst of exchanges against readRemoteNs, e.g.
+    // [&]() { return analyzer->timestampClockNs(); }
+    template<typename ReadRemote>
+    void probe(ReadRemote readRemoteNs, int exchanges = 16)
+    {
+        for (int i = 0; i < exchanges; i++) {
+            uint64_t sendNs = steadyClockNs();
+            uint64_t remoteNs = readRemoteNs();
+            uint64_t receiveNs = steadyClockNs();
+            addExchange(sendNs, remoteNs, receiveNs);
+        }
+    }
+
+    bool isSynchronized() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_exchanges.empty();
+    }
+
+    // Plugin clock minus host clock at hostNs
+    double offsetNs(uint64_t hostNs) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return offsetAt(hostNs);
+    }
+
+    // Rate error of the plugin clock in parts per million
+    double driftPpm() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_drift * 1e6;
+    }
+
+    // Half the shortest round trip used by the fit: bound on the offset error
+    uint64_t uncertaintyNs() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_uncertaintyNs;
+    }
+
+    uint64_t toHostNs(uint64_t remoteNs) const
+    {
+        if (remoteNs == 0) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // The offset changes by ppm per second, one refinement is enough
+        double hostNs = static_cast<double>(remoteNs) - offsetAt(remoteNs);
+        hostNs = static_cast<double>(remoteNs) - offsetAt(static_cast<uint64_t>(hostNs));
+        return static_cast<uint64_t>(hostNs);
+    }
+
+    uint64_t toRemoteNs(uint64_t hostNs) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<uint64_t>(static_cast<double>(hostNs) + offsetAt(hostNs));
+    }
+
+    // A callback reporting an event stamped remoteTimestampNs arrived at
+    // hostDeliveredNs
+    void addEvent(uint64_t remoteTimestampNs, uint64_t hostDeliveredNs)
+    {
+        if (remoteTimestampNs == 0) {
+            return;
+        }
+        uint64_t eventNs = toHostNs(remoteTimestampNs);
+        m_eventLatency.record(hostDeliveredNs > eventNs ? hostDeliveredNs - eventNs : 0);
+    }
+
+    LatencyHistogram::Snapshot eventLatency() const
+    {
+        return m_eventLatency.snapshot();
+    }
+
+private:
+    struct Exchange {
+        uint64_t hostNs;
+        double offsetNs;
+        uint64_t roundTripNs;
+    };
+
+    double offsetAt(uint64_t hostNs) const
+    {
+        double dt = static_cast<double>(static_cast<int64_t>(hostNs - m_referenceNs));
+        return m_offsetNs + m_drift * dt;
+    }
+
+    // Least squares line through the offsets of the tightest exchanges
+    void fit()
+    {
+        std::vector<Exchange> best(m_exchanges.begin(), m_exchanges.end());
+        std::sort(best.begin(), best.end(), [](const Exchange &a, const Exchange &b) {
+            return a.roundTripNs < b.roundTripNs;
+        });
+        size_t count = std::max<size_t>(std::min<size_t>(best.size(), 4), best.size() / 4);
+        best.resize(count);
+        m_uncertaintyNs = best.front().roundTripNs / 2;
+        m_referenceNs = best.front().hostNs;
+
+        double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+        for (const Exchange &exchange : best) {
+            double x = static_cast<double>(static_cast<int64_t>(exchange.hostNs - m_referenceNs));
+            sumX += x;
+            sumY += exchange.offsetNs;
+            sumXX += x * x;
+            sumXY += x * exchange.offsetNs;
+        }
+        double n = static_cast<double>(count);
+        double denominator = n * sumXX - sumX * sumX;
+        // Exchanges within a millisecond cannot resolve drift
+        if (count >= 4 && denominator > n * n * 1e12) {
+            m_drift = (n * sumXY - sumX * sumY) / denominator;
+            m_offsetNs = (sumY - m_drift * sumX) / n;
+        } else {
+            m_drift = 0.0;
+            m_offsetNs = best.front().offsetNs;
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::deque<Exchange> m_exchanges;
+    double m_offsetNs;
+    double m_drift;
+    uint64_t m_referenceNs;
+    uint64_t m_uncertaintyNs;
+    LatencyHistogram m_eventLatency;
+};
+
+// Recent positioner samples (e.g. fed from onPositionSampled), with the
+// position interpolated at any timestamp inside the kept range
+class PositionHistory
+{
+public:
+    explicit PositionHistory(size_t capacity = 4096)
+        : m_capacity(capacity > 2 ? capacity : 2)
+    {
+    }
+
+    // Samples are expected in timestamp order; older ones are ignored
+    void add(const PositionSample &sample)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_samples.empty() && sample.timestampNs < m_samples.back().timestampNs) {
+            return;
+        }
+        m_samples.push_back(sample);
+        if (m_samples.size() > m_capacity) {
+            m_samples.pop_front();
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_samples.clear();
+    }
+
+    // Linear interpolation between the samples around timestampNs.
+    // Returns false if timestampNs is outside the kept samples.
+    bool at(uint64_t timestampNs, PositionSample &position) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_samples.empty() || timestampNs < m_samples.front().timestampNs ||
+            timestampNs > m_samples.back().timestampNs) {
+            return false;
+        }
+        auto after = std::lower_bound(m_samples.begin(), m_samples.end(), timestampNs,
+                                      [](const PositionSample &sample, uint64_t t) {
+                                          return sample.timestampNs < t;
+                                      });
+        if (after->timestampNs == timestampNs || after == m_samples.begin()) {
+            position = *after;
+            return true;
+        }
+        const PositionSample &before = *(after - 1);
+        double f = static_cast<double>(timestampNs - before.timestampNs) /
+                   static_cast<double>(after->timestampNs - before.timestampNs);
+        position.AZ = before.AZ + f * (after->AZ - before.AZ);
+        position.EL = before.EL + f * (after->EL - before.EL);
+        position.POL = before.POL + f * (after->POL - before.POL);
+        position.timestampNs = timestampNs;
+        return true;
+    }
+
+private:
+    size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::deque<PositionSample> m_samples;
+};
+
+#endif // CLOCKSYNC_H
@@ -0,0 +1,1107 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef INSTRUMENTEDPLUGINS_H
+#define INSTRUMENTEDPLUGINS_H
+
+#include "iplugininterface.h"
+#include "common/latencyhistogram.h"
+#include "common/pluginmetrics.h"
+#include "common/tracetimeline.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Host-side decorators that wrap a loaded plugin, forward every call to it
+// and keep per-method latency histograms plus call and error counts.
+//
+// Usage:
+//     ISignalAnalyzerPlugin* raw = createFunc();
+//     InstrumentedSignalAnalyzer sa(raw, "Dummy SA");
+//     sa.onPeakFound = ...;          // callbacks are set on the decorator
+//     sa.findPeak();
+//     sa.instrumentation().dump(std::cout);
+//     sa.publishMetrics(MetricsSegment::global());   // optional
+//     sa.instrumentation().traceTo(&TraceRecorder::global());   // optional
+//
+// The decorator does not own the wrapped plugin. Destroy the decorator
+// before the plugin, and only after the plugin has stopped raising
+// callbacks from its own threads.
+
+// Same clock as the trace timeline so durations and spans line up
+inline uint64_t instrumentationNowNs()
+{
+    return traceNowNs();
+}
+
+// Statistics for one instrumented method
+struct MethodStats {
+    LatencyHistogram latency;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+// Query result for one instrumented method
+struct MethodReport {
+    std::string name;
+    uint64_t calls;
+    uint64_t errors;
+    LatencyHistogram::Snapshot latency;
+};
+
+class PluginInstrumentation
+{
+public:
+    // RAII timer for one forwarded call. Errors reported through the
+    // plugin's onError callback while the call is in flight on the same
+    // thread are attributed to it.
+    class Call
+    {
+    public:
+        Call(PluginInstrumentation &instrumentation, size_t method)
+            : m_instrumentation(instrumentation)
+            , m_method(method)
+            , m_failed(false)
+            , m_previous(current())
+            , m_startNs(instrumentationNowNs())
+        {
+            current() = this;
+        }
+
+        ~Call()
+        {
+            uint64_t endNs = instrumentationNowNs();
+            current() = m_previous;
+
+            m_instrumentation.recordDuration(m_method, endNs - m_startNs, m_failed);
+            if (m_instrumentation.m_trace) {
+                m_instrumentation.m_trace->complete(m_instrumentation.m_traceLane,
+                                                    m_instrumentation.m_methodNames[m_method], "call",
+                                                    m_startNs, endNs,
+                                                    m_failed ? "failed" : nullptr, 1.0);
+            }
+        }
+
+        Call(const Call &) = delete;
+        Call &operator=(const Call &) = delete;
+
+        void fail() { m_failed = true; }
+        bool failed() const { return m_failed; }
+
+        // Convenience for bool-returning methods
+        bool result(bool ok)
+        {
+            if (!ok) {
+                m_failed = true;
+            }
+            return ok;
+        }
+
+    private:
+        friend class PluginInstrumentation;
+
+        static Call *&current()
+        {
+            static thread_local Call *call = nullptr;
+            return call;
+        }
+
+        PluginInstrumentation &m_instrumentation;
+        size_t m_method;
+        bool m_failed;
+        Call *m_previous;
+        uint64_t m_startNs;
+    };
+
+    // Trace span around a callback raised by the wrapped plugin, recorded
+    // on the thread that raised it
+    class Dispatch
+    {
+    public:
+        Dispatch(PluginInstrumentation &instrumentation, const char *callbackName)
+            : m_span(instrumentation.m_trace, instrumentation.m_traceLane, callbackName, "callback")
+        {
+        }
+
+    private:
+        TraceSpan m_span;
+    };
+
+    PluginInstrumentation(const std::string &instrumentName, std::vector<const char*> methodNames)
+        : m_instrumentName(instrumentName)
+        , m_methodNames(std::move(methodNames))
+        , m_stats(new MethodStats[m_methodNames.size()])
+        , m_callCounters(new MetricCounter[m_methodNames.size()])
+        , m_errorCounters(new MetricCounter[m_methodNames.size()])
+        , m_asyncErrors(0)
+        , m_trace(nullptr)
+        , m_traceLane(0)
+    {
+    }
+
+    // Mirror call and error counts into a shared-memory metrics segment
+    // as antenna_plugin_calls_total / antenna_plugin_errors_total.
+    // Call before the plugin is used from other threads.
+    void publishTo(MetricsSegment &segment)
+    {
+        std::string instrument = metricLabel("instrument", m_instrumentName);
+        for (size_t i = 0; i < m_methodNames.size(); i++) {
+            std::string labels = instrument + "," + metricLabel("method", m_methodNames[i]);
+            m_callCounters[i] = segment.counter("antenna_plugin_calls_total", labels,
+                                                "Plugin calls per method");
+            m_errorCounters[i] = segment.counter("antenna_plugin_errors_total", labels,
+                                                 "Failed plugin calls per method");
+        }
+        m_asyncErrorCounter = segment.counter("antenna_plugin_async_errors_total", instrument,
+                                              "Errors raised outside plugin calls");
+    }
+
+    // Record every call and callback as a span in the instrument's lane of
+    // a trace timeline (nullptr turns tracing off). Like publishTo(), call
+    // before the plugin is used from other threads.
+    void traceTo(TraceRecorder *recorder)
+    {
+        m_traceLane = recorder ? recorder->lane(m_instrumentName) : 0;
+        m_trace = recorder;
+    }
+
+    // Span that is not bound to a call on one thread (e.g. positioner motion)
+    void traceAsync(const char *name, const char *category, uint64_t startNs, uint64_t endNs)
+    {
+        if (m_trace) {
+            m_trace->async(m_traceLane, name, category, startNs, endNs);
+        }
+    }
+
+    const std::string &instrumentName() const { return m_instrumentName; }
+    size_t methodCount() const { return m_methodNames.size(); }
+    const char *methodName(size_t method) const { return m_methodNames[method]; }
+
+    MethodStats &method(size_t method) { return m_stats[method]; }
+    const MethodStats &method(size_t method) const { return m_stats[method]; }
+
+    // Errors the plugin reported outside of any instrumented call
+    // (e.g. from a movement thread)
+    uint64_t asyncErrors() const { return m_asyncErrors.load(std::memory_order_relaxed); }
+
+    MethodReport report(size_t method) const
+    {
+        MethodReport r;
+        r.name = m_methodNames[method];
+        r.calls = m_stats[method].calls.load(std::memory_order_relaxed);
+        r.errors = m_stats[method].errors.load(std::memory_order_relaxed);
+        r.latency = m_stats[method].latency.snapshot();
+        return r;
+    }
+
+    std::vector<MethodReport> reports() const
+    {
+        std::vector<MethodReport> all;
+        all.reserve(m_methodNames.size());
+        for (size_t i = 0; i < m_methodNames.size(); i++) {
+            all.push_back(report(i));
+        }
+        return all;
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < m_methodNames.size(); i++) {
+            m_stats[i].latency.reset();
+            m_stats[i].calls.store(0, std::memory_order_relaxed);
+            m_stats[i].errors.store(0, std::memory_order_relaxed);
+        }
+        m_asyncErrors.store(0, std::memory_order_relaxed);
+    }
+
+    // Record a duration that is not bound to a single call (e.g. the time
+    // from moveTo() until onMovementStopped)
+    void recordDuration(size_t method, uint64_t elapsedNs, bool failed = false)
+    {
+        m_stats[method].calls.fetch_add(1, std::memory_order_relaxed);
+        m_callCounters[method].add();
+        if (failed) {
+            m_stats[method].errors.fetch_add(1, std::memory_order_relaxed);
+            m_errorCounters[method].add();
+        }
+        m_stats[method].latency.record(elapsedNs);
+    }
+
+    // Routed from the wrapped plugin's onError callback
+    void noteError()
+    {
+        for (Call *call = Call::current(); call != nullptr; call = call->m_previous) {
+            if (&call->m_instrumentation == this) {
+                call->fail();
+                return;
+            }
+        }
+        m_asyncErrors.fetch_add(1, std::memory_order_relaxed);
+        m_asyncErrorCounter.add();
+    }
+
+    // Only methods that have been called are listed
+    void dump(std::ostream &out) const
+    {
+        std::ostringstream text;
+        text << "[Instrumentation] " << m_instrumentName << std::endl;
+        text << "  " << std::left << std::setw(20) << "method" << std::right
+             << std::setw(8) << "calls" << std::setw(8) << "errors"
+             << std::setw(11) << "mean ms" << std::setw(11) << "p50 ms"
+             << std::setw(11) << "p90 ms" << std::setw(11) << "p99 ms"
+             << std::setw(11) << "max ms" << std::endl;
+        text << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < m_methodNames.size(); i++) {
+            MethodReport r = report(i);
+            if (r.calls == 0) {
+                continue;
+            }
+            text << "  " << std::left << std::setw(20) << r.name << std::right
+                 << std::setw(8) << r.calls << std::setw(8) << r.errors
+                 << std::setw(11) << r.latency.meanNs() / 1e6
+                 << std::setw(11) << r.latency.percentileNs(0.50) / 1e6
+                 << std::setw(11) << r.latency.percentileNs(0.90) / 1e6
+                 << std::setw(11) << r.latency.percentileNs(0.99) / 1e6
+                 << std::setw(11) << r.latency.maxNs / 1e6 << std::endl;
+        }
+        if (asyncErrors() > 0) {
+            text << "  asynchronous errors: " << asyncErrors() << std::endl;
+        }
+        out << text.str();
+    }
+
+private:
+    std::string m_instrumentName;
+    std::vector<const char*> m_methodNames;
+    std::unique_ptr<MethodStats[]> m_stats;
+    std::unique_ptr<MetricCounter[]> m_callCounters;
+    std::unique_ptr<MetricCounter[]> m_errorCounters;
+    MetricCounter m_asyncErrorCounter;
+    std::atomic<uint64_t> m_asyncErrors;
+    TraceRecorder *m_trace;
+    uint32_t m_traceLane;
+};
+
+// Signal Analyzer decorator
+class InstrumentedSignalAnalyzer : public ISignalAnalyzerPlugin
+{
+public:
+    enum Method {
+        ScanDevices,
+        ConnectToDevice,
+        Connect,
+        Disconnect,
+        SetStartFreq,
+        SetStopFreq,
+        SetRBW,
+        FindPeak,
+        FindPeakFast,
+        ReadTrace,
+        SetTriggerIn,
+        CaptureZeroSpan,
+        MethodCount
+    };
+
+    InstrumentedSignalAnalyzer(ISignalAnalyzerPlugin *plugin, const std::string &instrumentName)
+        : m_plugin(plugin)
+        , m_instrumentation(instrumentName, {
+              "scanDevices", "connectToDevice", "connect", "disconnect",
+              "setStartFreq", "setStopFreq", "setRBW", "findPeak", "findPeakFast", "readTrace",
+              "setTriggerIn", "captureZeroSpan"})
+    {
+        m_plugin->onConnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onConnected");
+            if (onConnected) onConnected();
+        };
+        m_plugin->onDisconnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDisconnected");
+            if (onDisconnected) onDisconnected();
+        };
+        m_plugin->onPeakFound = [this](const Peak &peak) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onPeakFound");
+            if (onPeakFound) onPeakFound(peak);
+        };
+        m_plugin->onError = [this](const std::string &error) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onError");
+            m_instrumentation.noteError();
+            if (onError) onError(error);
+        };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDevicesScanned");
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+    }
+
+    ~InstrumentedSignalAnalyzer() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onPeakFound = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+    }
+
+    ISignalAnalyzerPlugin *plugin() const { return m_plugin; }
+    PluginInstrumentation &instrumentation() { return m_instrumentation; }
+    const PluginInstrumentation &instrumentation() const { return m_instrumentation; }
+
+    // Publish call/error counters and antenna_points_measured_total
+    void publishMetrics(MetricsSegment &segment)
+    {
+        m_instrumentation.publishTo(segment);
+        m_pointsMeasured = segment.counter("antenna_points_measured_total",
+                                           metricLabel("instrument", m_instrumentation.instrumentName()),
+                                           "Peaks measured without error");
+    }
+
+    // Device discovery
+    std::vector<DeviceInfo> scanDevices() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ScanDevices);
+        return m_plugin->scanDevices();
+    }
+
+    bool connectToDevice(const std::string &address) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ConnectToDevice);
+        return call.result(m_plugin->connectToDevice(address));
+    }
+
+    // Connection management
+    bool connect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Connect);
+        return call.result(m_plugin->connect());
+    }
+
+    void disconnect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Disconnect);
+        m_plugin->disconnect();
+    }
+
+    bool isConnected() const override { return m_plugin->isConnected(); }
+
+    // Configuration
+    void setStartFreq(double freqHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetStartFreq);
+        m_plugin->setStartFreq(freqHz);
+    }
+
+    void setStopFreq(double freqHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetStopFreq);
+        m_plugin->setStopFreq(freqHz);
+    }
+
+    void setRBW(double freqHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetRBW);
+        m_plugin->setRBW(freqHz);
+    }
+
+    // Measurement
+    Peak findPeak() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, FindPeak);
+        Peak peak = m_plugin->findPeak();
+        if (!call.failed()) {
+            m_pointsMeasured.add();
+        }
+        return peak;
+    }
+
+    Peak findPeakFast(double targetAccuracyHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, FindPeakFast);
+        Peak peak = m_plugin->findPeakFast(targetAccuracyHz);
+        if (!call.failed()) {
+            m_pointsMeasured.add();
+        }
+        return peak;
+    }
+
+    bool readTrace(Trace &trace) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ReadTrace);
+        return call.result(m_plugin->readTrace(trace));
+    }
+
+    // Not instrumented: the call is timed by the clock probe itself
+    uint64_t timestampClockNs() override { return m_plugin->timestampClockNs(); }
+
+    bool setTriggerIn(TriggerInMode mode, double timeoutS) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetTriggerIn);
+        return call.result(m_plugin->setTriggerIn(mode, timeoutS));
+    }
+    
+    bool captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                         ZeroSpanCapture &capture) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, CaptureZeroSpan);
+        return call.result(m_plugin->captureZeroSpan(centerFreqHz, rbwHz, sampleRateHz, durationS, capture));
+    }
+
+private:
+    ISignalAnalyzerPlugin *m_plugin;
+    PluginInstrumentation m_instrumentation;
+    MetricCounter m_pointsMeasured;
+};
+
+// Signal Generator decorator
+class InstrumentedSignalGenerator : public ISignalGeneratorPlugin
+{
+public:
+    enum Method {
+        ScanDevices,
+        ConnectToDevice,
+        Connect,
+        Disconnect,
+        SetFreq,
+        SetPower,
+        EnableRf,
+        DisableRf,
+        SetSettledMode,
+        SetChannelFreq,
+        SetChannelPower,
+        SetChannelRfEnabled,
+        LoadHopTable,
+        HopTo,
+        SetHopVerification,
+        LoadFreqList,
+        StartFreqList,
+        StopFreqList,
+        AnnounceIdle,
+        SetTriggerOut,
+        SetTriggerIn,
+        MethodCount
+    };
+
+    InstrumentedSignalGenerator(ISignalGeneratorPlugin *plugin, const std::string &instrumentName)
+        : m_plugin(plugin)
+        , m_instrumentation(instrumentName, {
+              "scanDevices", "connectToDevice", "connect", "disconnect",
+              "setFreq", "setPower", "enableRf", "disableRf", "setSettledMode",
+              "setChannelFreq", "setChannelPower", "setChannelRfEnabled",
+              "loadHopTable", "hopTo", "setHopVerification",
+              "loadFreqList", "startFreqList", "stopFreqList", "announceIdle",
+              "setTriggerOut", "setTriggerIn"})
+    {
+        m_plugin->onConnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onConnected");
+            if (onConnected) onConnected();
+        };
+        m_plugin->onDisconnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDisconnected");
+            if (onDisconnected) onDisconnected();
+        };
+        m_plugin->onRfEnabled = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onRfEnabled");
+            if (onRfEnabled) onRfEnabled();
+        };
+        m_plugin->onRfDisabled = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onRfDisabled");
+            if (onRfDisabled) onRfDisabled();
+        };
+        m_plugin->onError = [this](const std::string &error) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onError");
+            m_instrumentation.noteError();
+            if (onError) onError(error);
+        };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDevicesScanned");
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+        m_plugin->onFreqSettled = [this](double freqHz, double lockTimeUs) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onFreqSettled");
+            if (onFreqSettled) onFreqSettled(freqHz, lockTimeUs);
+        };
+    }
+
+    ~InstrumentedSignalGenerator() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onRfEnabled = nullptr;
+        m_plugin->onRfDisabled = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+        m_plugin->onFreqSettled = nullptr;
+    }
+
+    ISignalGeneratorPlugin *plugin() const { return m_plugin; }
+    PluginInstrumentation &instrumentation() { return m_instrumentation; }
+    const PluginInstrumentation &instrumentation() const { return m_instrumentation; }
+
+    // Publish call/error counters, antenna_rf_enabled and
+    // antenna_rf_on_seconds_total. RF on-time is accounted on every call
+    // made through the decorator.
+    void publishMetrics(MetricsSegment &segment)
+    {
+        std::string instrument = metricLabel("instrument", m_instrumentation.instrumentName());
+        m_instrumentation.publishTo(segment);
+        m_rfEnabledGauge = segment.gauge("antenna_rf_enabled", instrument, "RF output state (1 = on)");
+        m_rfOnSeconds = segment.floatCounter("antenna_rf_on_seconds_total", instrument,
+                                             "Accumulated RF output on-time");
+        updateRfOnTime();
+    }
+
+    // Device discovery
+    std::vector<DeviceInfo> scanDevices() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ScanDevices);
+        return m_plugin->scanDevices();
+    }
+
+    bool connectToDevice(const std::string &address) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ConnectToDevice);
+        bool ok = call.result(m_plugin->connectToDevice(address));
+        updateRfOnTime();
+        return ok;
+    }
+
+    // Connection management
+    bool connect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Connect);
+        bool ok = call.result(m_plugin->connect());
+        updateRfOnTime();
+        return ok;
+    }
+
+    void disconnect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Disconnect);
+        m_plugin->disconnect();
+        updateRfOnTime();
+    }
+
+    bool isConnected() const override { return m_plugin->isConnected(); }
+
+    // Configuration
+    void setFreq(double freqHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetFreq);
+        m_plugin->setFreq(freqHz);
+        updateRfOnTime();
+    }
+
+    void setPower(double powerDbm) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetPower);
+        m_plugin->setPower(powerDbm);
+        updateRfOnTime();
+    }
+
+    // RF Control
+    void enableRf() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, EnableRf);
+        m_plugin->enableRf();
+        updateRfOnTime();
+    }
+
+    void disableRf() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, DisableRf);
+        m_plugin->disableRf();
+        updateRfOnTime();
+    }
+
+    bool isRfEnabled() const override { return m_plugin->isRfEnabled(); }
+    bool getPower(double &powerDbm) const override { return m_plugin->getPower(powerDbm); }
+
+    bool setSettledMode(bool enabled, double timeoutMs) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetSettledMode);
+        return call.result(m_plugin->setSettledMode(enabled, timeoutMs));
+    }
+
+    // Multi-channel
+    int channelCount() const override { return m_plugin->channelCount(); }
+    bool channelInfo(int channel, ChannelInfo &info) const override { return m_plugin->channelInfo(channel, info); }
+
+    bool setChannelFreq(int channel, double freqHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetChannelFreq);
+        bool ok = call.result(m_plugin->setChannelFreq(channel, freqHz));
+        updateRfOnTime();
+        return ok;
+    }
+
+    bool setChannelPower(int channel, double powerDbm) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetChannelPower);
+        bool ok = call.result(m_plugin->setChannelPower(channel, powerDbm));
+        updateRfOnTime();
+        return ok;
+    }
+
+    bool setChannelRfEnabled(int channel, bool enabled) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetChannelRfEnabled);
+        bool ok = call.result(m_plugin->setChannelRfEnabled(channel, enabled));
+        updateRfOnTime();
+        return ok;
+    }
+
+    bool isChannelRfEnabled(int channel) const override { return m_plugin->isChannelRfEnabled(channel); }
+
+    // Frequency hopping
+    bool loadHopTable(const std::vector<double> &freqsHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, LoadHopTable);
+        return call.result(m_plugin->loadHopTable(freqsHz));
+    }
+
+    bool hopTo(size_t index) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, HopTo);
+        return call.result(m_plugin->hopTo(index));
+    }
+
+    bool setHopVerification(bool enabled) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetHopVerification);
+        return call.result(m_plugin->setHopVerification(enabled));
+    }
+
+    // List mode
+    bool loadFreqList(const std::vector<double> &freqsHz) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, LoadFreqList);
+        return call.result(m_plugin->loadFreqList(freqsHz));
+    }
+
+    bool startFreqList(double dwellS, unsigned int cycles) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, StartFreqList);
+        return call.result(m_plugin->startFreqList(dwellS, cycles));
+    }
+
+    bool stopFreqList() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, StopFreqList);
+        return call.result(m_plugin->stopFreqList());
+    }
+
+    // Power management
+    bool announceIdle(double idleS) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, AnnounceIdle);
+        return call.result(m_plugin->announceIdle(idleS));
+    }
+
+    bool setTriggerOut(TriggerOutMode mode) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetTriggerOut);
+        return call.result(m_plugin->setTriggerOut(mode));
+    }
+
+    bool setTriggerIn(TriggerInMode mode) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetTriggerIn);
+        return call.result(m_plugin->setTriggerIn(mode));
+    }
+
+private:
+    void updateRfOnTime()
+    {
+        if (!m_rfOnSeconds.isValid()) {
+            return;
+        }
+        bool enabled = m_plugin->isRfEnabled();
+        uint64_t now = instrumentationNowNs();
+        uint64_t since = m_rfOnSinceNs.exchange(enabled ? now : 0);
+        if (since != 0) {
+            m_rfOnSeconds.add(static_cast<double>(now - since) / 1e9);
+        }
+        m_rfEnabledGauge.set(enabled ? 1.0 : 0.0);
+    }
+
+    ISignalGeneratorPlugin *m_plugin;
+    PluginInstrumentation m_instrumentation;
+    MetricGauge m_rfEnabledGauge;
+    MetricGauge m_rfOnSeconds;
+    std::atomic<uint64_t> m_rfOnSinceNs{0};
+};
+
+// Positioner decorator. Besides the calls themselves it records "motion",
+// the time from moveTo()/start() until the plugin raises onMovementStopped,
+// which is where positioner settle time shows up.
+class InstrumentedPositioner : public IPositionerPlugin
+{
+public:
+    enum Method {
+        ScanDevices,
+        ConnectToDevice,
+        Connect,
+        Disconnect,
+        SetAZStep,
+        SetStep,
+        SetMinRange,
+        SetMaxRange,
+        SetMovement,
+        SetDistance,
+        Start,
+        Stop,
+        MoveTo,
+        Motion,
+        QueueWaypoints,
+        SetPositionCompare,
+        MethodCount
+    };
+
+    InstrumentedPositioner(IPositionerPlugin *plugin, const std::string &instrumentName)
+        : m_plugin(plugin)
+        , m_instrumentation(instrumentName, {
+              "scanDevices", "connectToDevice", "connect", "disconnect",
+              "setAZStep", "setStep", "setMinRange", "setMaxRange",
+              "setMovement", "setDistance", "start", "stop", "moveTo", "motion",
+              "queueWaypoints", "setPositionCompare"})
+        , m_motionStartNs(0)
+    {
+        m_plugin->onConnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onConnected");
+            if (onConnected) onConnected();
+        };
+        m_plugin->onDisconnected = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDisconnected");
+            if (onDisconnected) onDisconnected();
+        };
+        m_plugin->onMovementStarted = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onMovementStarted");
+            if (onMovementStarted) onMovementStarted();
+        };
+        m_plugin->onMovementStopped = [this]() {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onMovementStopped");
+            uint64_t startNs = m_motionStartNs.exchange(0);
+            if (startNs != 0) {
+                uint64_t endNs = instrumentationNowNs();
+                m_instrumentation.recordDuration(Motion, endNs - startNs);
+                m_instrumentation.traceAsync("motion", "motion", startNs, endNs);
+            }
+            if (onMovementStopped) onMovementStopped();
+        };
+        m_plugin->onPositionChanged = [this](double az, double el, double pol) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onPositionChanged");
+            accountTravel(az, el, pol);
+            if (onPositionChanged) onPositionChanged(az, el, pol);
+        };
+        m_plugin->onPositionSampled = [this](const PositionSample &sample) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onPositionSampled");
+            if (onPositionSampled) onPositionSampled(sample);
+        };
+        m_plugin->onWaypointReached = [this](int id, double az, double el, double pol) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onWaypointReached");
+            if (onWaypointReached) onWaypointReached(id, az, el, pol);
+        };
+        m_plugin->onError = [this](const std::string &error) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onError");
+            m_instrumentation.noteError();
+            if (onError) onError(error);
+        };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            PluginInstrumentation::Dispatch dispatch(m_instrumentation, "onDevicesScanned");
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+    }
+
+    ~InstrumentedPositioner() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onMovementStarted = nullptr;
+        m_plugin->onMovementStopped = nullptr;
+        m_plugin->onPositionChanged = nullptr;
+        m_plugin->onPositionSampled = nullptr;
+        m_plugin->onWaypointReached = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+    }
+
+    IPositionerPlugin *plugin() const { return m_plugin; }
+    PluginInstrumentation &instrumentation() { return m_instrumentation; }
+    const PluginInstrumentation &instrumentation() const { return m_instrumentation; }
+
+    // Publish call/error counters and antenna_positioner_travel_degrees_total
+    // (accumulated from onPositionChanged) per axis
+    void publishMetrics(MetricsSegment &segment)
+    {
+        std::string instrument = metricLabel("instrument", m_instrumentation.instrumentName());
+        m_instrumentation.publishTo(segment);
+        const char *axes[3] = { "AZ", "EL", "POL" };
+        for (int i = 0; i < 3; i++) {
+            m_travel[i] = segment.floatCounter("antenna_positioner_travel_degrees_total",
+                                               instrument + "," + metricLabel("axis", axes[i]),
+                                               "Accumulated positioner travel");
+        }
+    }
+
+    // Device discovery
+    std::vector<DeviceInfo> scanDevices() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ScanDevices);
+        return m_plugin->scanDevices();
+    }
+
+    bool connectToDevice(const std::string &address) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, ConnectToDevice);
+        return call.result(m_plugin->connectToDevice(address));
+    }
+
+    // Connection management
+    bool connect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Connect);
+        return call.result(m_plugin->connect());
+    }
+
+    void disconnect() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Disconnect);
+        m_plugin->disconnect();
+    }
+
+    bool isConnected() const override { return m_plugin->isConnected(); }
+
+    // Configuration
+    void setAZStep(double degrees) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetAZStep);
+        m_plugin->setAZStep(degrees);
+    }
+
+    void setStep(const Step &step) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetStep);
+        m_plugin->setStep(step);
+    }
+
+    void setMinRange(const MinRange &minRange) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetMinRange);
+        m_plugin->setMinRange(minRange);
+    }
+
+    void setMaxRange(const MaxRange &maxRange) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetMaxRange);
+        m_plugin->setMaxRange(maxRange);
+    }
+
+    void setMovement(const Movement &movement) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetMovement);
+        m_plugin->setMovement(movement);
+    }
+
+    void setDistance(double distance) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetDistance);
+        m_plugin->setDistance(distance);
+    }
+
+    // Get Position
+    double getCurrentAZ() const override { return m_plugin->getCurrentAZ(); }
+    double getCurrentEL() const override { return m_plugin->getCurrentEL(); }
+    double getCurrentPOL() const override { return m_plugin->getCurrentPOL(); }
+    uint64_t timestampClockNs() override { return m_plugin->timestampClockNs(); }
+
+    // Control
+    void start() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Start);
+        m_motionStartNs.store(instrumentationNowNs());
+        m_plugin->start();
+    }
+
+    void stop() override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, Stop);
+        m_plugin->stop();
+    }
+
+    // moveTo() only posts the command; the movement thread may report a
+    // short move as stopped before the call returns, so the start time is
+    // stored first. A moveTo() during a motion retargets it and restarts
+    // the measured interval.
+    void moveTo(double azimuth, double elevation) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, MoveTo);
+        m_motionStartNs.store(instrumentationNowNs());
+        m_plugin->moveTo(azimuth, elevation);
+    }
+
+    void moveTo(double azimuth, double elevation, double polar) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, MoveTo);
+        m_motionStartNs.store(instrumentationNowNs());
+        m_plugin->moveTo(azimuth, elevation, polar);
+    }
+
+    // Waypoints appended to a running path extend the current motion
+    bool queueWaypoints(const std::vector<Waypoint> &waypoints) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, QueueWaypoints);
+        uint64_t startNs = instrumentationNowNs();
+        uint64_t idle = 0;
+        bool started = m_motionStartNs.compare_exchange_strong(idle, startNs);
+        bool ok = m_plugin->queueWaypoints(waypoints);
+        if (!ok && started) {
+            m_motionStartNs.compare_exchange_strong(startNs, 0);
+        }
+        return call.result(ok);
+    }
+
+    bool setPositionCompare(int axis, double startDeg, double intervalDeg, unsigned int count) override
+    {
+        PluginInstrumentation::Call call(m_instrumentation, SetPositionCompare);
+        return call.result(m_plugin->setPositionCompare(axis, startDeg, intervalDeg, count));
+    }
+
+private:
+    // Position callbacks come from one movement thread at a time
+    void accountTravel(double az, double el, double pol)
+    {
+        double position[3] = { az, el, pol };
+        if (m_hasLastPosition) {
+            for (int i = 0; i < 3; i++) {
+                double delta = position[i] - m_lastPosition[i];
+                m_travel[i].add(delta < 0 ? -delta : delta);
+            }
+        } else {
+            m_hasLastPosition = true;
+        }
+        for (int i = 0; i < 3; i++) {
+            m_lastPosition[i] = position[i];
+        }
+    }
+
+    IPositionerPlugin *m_plugin;
+    PluginInstrumentation m_instrumentation;
+    std::atomic<uint64_t> m_motionStartNs;
+    MetricGauge m_travel[3];
+    double m_lastPosition[3] = { 0.0, 0.0, 0.0 };
+    bool m_hasLastPosition = false;
+};
+
+// Writes the statistics of a set of instrumented plugins periodically
+class InstrumentationReporter
+{
+public:
+    typedef std::function<void(const std::string&)> Sink;
+
+    InstrumentationReporter()
+        : m_running(false)
+    {
+    }
+
+    ~InstrumentationReporter()
+    {
+        stop();
+    }
+
+    // Instrumentation objects must outlive the reporter or be removed first
+    void add(const PluginInstrumentation *instrumentation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_instrumentations.push_back(instrumentation);
+    }
+
+    void remove(const PluginInstrumentation *instrumentation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_instrumentations.begin(); it != m_instrumentations.end(); ++it) {
+            if (*it == instrumentation) {
+                m_instrumentations.erase(it);
+                break;
+            }
+        }
+    }
+
+    void dumpNow(std::ostream &out) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const PluginInstrumentation *instrumentation : m_instrumentations) {
+            instrumentation->dump(out);
+        }
+    }
+
+    // Start dumping every interval; the default sink writes to std::cout
+    void start(std::chrono::milliseconds interval, Sink sink = nullptr)
+    {
+        stop();
+        if (!sink) {
+            sink = [](const std::string &text) { std::cout << text << std::flush; };
+        }
+        m_running = true;
+        m_thread = std::thread([this, interval, sink]() {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            while (m_running) {
+                m_wake.wait_for(lock, interval, [this]() { return !m_running; });
+                if (!m_running) {
+                    break;
+                }
+                std::ostringstream text;
+                dumpNow(text);
+                sink(text.str());
+            }
+        });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<const PluginInstrumentation*> m_instrumentations;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_running;
+    std::thread m_thread;
+};
+
+#endif // INSTRUMENTEDPLUGINS_H
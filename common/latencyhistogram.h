@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Lock-free latency histogram with logarithmic buckets (HDR-style).
+//
+// Values are recorded in nanoseconds. Every power of two is split into
+// 16 linear sub-buckets, so any reported value is within ~6% of the
+// recorded one, from 1 ns up to the full uint64 range. record() only
+// performs relaxed atomic increments and is safe to call from any thread.
+class LatencyHistogram
+{
+public:
+    static constexpr int SubBucketBits = 4;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+    // Point-in-time copy of a histogram, used for queries and reports
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sumNs = 0;
+        uint64_t minNs = 0;
+        uint64_t maxNs = 0;
+        std::array<uint64_t, BucketCount> buckets{};
+
+        double meanNs() const
+        {
+            return count ? static_cast<double>(sumNs) / static_cast<double>(count) : 0.0;
+        }
+
+        // Value at quantile q (0..1), reported as the bucket midpoint
+        uint64_t percentileNs(double q) const
+        {
+            if (count == 0) {
+                return 0;
+            }
+            if (q <= 0.0) {
+                return minNs;
+            }
+            if (q >= 1.0) {
+                return maxNs;
+            }
+            // Nearest-rank definition
+            uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+            if (rank == 0) {
+                rank = 1;
+            }
+            uint64_t seen = 0;
+            for (int i = 0; i < BucketCount; i++) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    uint64_t mid = bucketLowerBound(i) + bucketWidth(i) / 2;
+                    if (mid < minNs) return minNs;
+                    if (mid > maxNs) return maxNs;
+                    return mid;
+                }
+            }
+            return maxNs;
+        }
+    };
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record(uint64_t valueNs)
+    {
+        m_buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumNs.fetch_add(valueNs, std::memory_order_relaxed);
+
+        uint64_t current = m_minNs.load(std::memory_order_relaxed);
+        while (valueNs < current &&
+               !m_minNs.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+        }
+        current = m_maxNs.load(std::memory_order_relaxed);
+        while (valueNs > current &&
+               !m_maxNs.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Not synchronized with concurrent record() calls; counts recorded
+    // during a reset may survive it.
+    void reset()
+    {
+        for (auto &bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumNs.store(0, std::memory_order_relaxed);
+        m_minNs.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        m_maxNs.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const
+    {
+        Snapshot snap;
+        uint64_t total = 0;
+        for (int i = 0; i < BucketCount; i++) {
+            snap.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += snap.buckets[i];
+        }
+        // Use the bucket total so percentiles stay consistent with the
+        // bucket contents even while other threads are recording.
+        snap.count = total;
+        snap.sumNs = m_sumNs.load(std::memory_order_relaxed);
+        snap.minNs = total ? m_minNs.load(std::memory_order_relaxed) : 0;
+        snap.maxNs = m_maxNs.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    static int bucketIndex(uint64_t value)
+    {
+        if (value < static_cast<uint64_t>(SubBucketCount)) {
+            return static_cast<int>(value);
+        }
+        int shift = highestBit(value) - SubBucketBits;
+        int sub = static_cast<int>((value >> shift) & (SubBucketCount - 1));
+        return (shift + 1) * SubBucketCount + sub;
+    }
+
+    static uint64_t bucketLowerBound(int index)
+    {
+        if (index < SubBucketCount) {
+            return static_cast<uint64_t>(index);
+        }
+        int shift = index / SubBucketCount - 1;
+        uint64_t sub = static_cast<uint64_t>(index % SubBucketCount);
+        return (static_cast<uint64_t>(SubBucketCount) + sub) << shift;
+    }
+
+    static uint64_t bucketWidth(int index)
+    {
+        if (index < SubBucketCount) {
+            return 1;
+        }
+        return uint64_t(1) << (index / SubBucketCount - 1);
+    }
+
+private:
+    static int highestBit(uint64_t value)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    std::array<std::atomic<uint64_t>, BucketCount> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sumNs;
+    std::atomic<uint64_t> m_minNs;
+    std::atomic<uint64_t> m_maxNs;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef MOTIONMODEL_H
+#define MOTIONMODEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+// Positioner axes with a mechanical model
+enum PositionerAxis {
+    AxisAZ = 0,
+    AxisEL = 1,
+    AxisPOL = 2,
+    AxisCount = 3
+};
+
+// Mechanical parameters of one positioner axis. Angles in degrees.
+struct AxisModel {
+    double maxVelocity;             // deg/s
+    double maxAcceleration;         // deg/s^2
+    double backlashDeg;             // total gear play between motor and load
+    double naturalFreqHz;           // load resonance behind the gear, 0 = rigid
+    double damping;                 // damping ratio of that resonance
+    double encoderResolutionDeg;    // load encoder quantization, 0 = exact
+    double encoderNoiseDeg;         // RMS encoder noise
+    double settleToleranceDeg;      // motion ends when the load stays within this
+
+    AxisModel()
+        : maxVelocity(20.0)
+        , maxAcceleration(40.0)
+        , backlashDeg(0.05)
+        , naturalFreqHz(8.0)
+        , damping(0.4)
+        , encoderResolutionDeg(0.01)
+        , encoderNoiseDeg(0.003)
+        , settleToleranceDeg(0.02)
+    {}
+};
+
+// Timing of a fixed-rate motion loop. Lateness is how long after its
+// deadline a tick started; an overrun is a tick missed entirely.
+struct MotionLoopStats {
+    double tickRateHz;
+    uint64_t ticks;
+    uint64_t overruns;
+    double meanLatenessUs;
+    double p99LatenessUs;
+    double maxLatenessUs;
+
+    MotionLoopStats() : tickRateHz(0.0), ticks(0), overruns(0), meanLatenessUs(0.0),
+                        p99LatenessUs(0.0), maxLatenessUs(0.0) {}
+};
+
+// Time-stepped simulation of one axis: a motor following a trapezoidal
+// velocity profile, gear backlash, an underdamped load behind the gear and
+// a noisy, quantized load-side encoder. The position loop closes on the
+// motor, so backlash shows up as an approach-direction dependent offset
+// of the load, as on real positioners with motor-side feedback.
+class AxisSimulator
+{
+public:
+    explicit AxisSimulator(const AxisModel &model = AxisModel(), unsigned int seed = 1)
+        : m_model(model)
+        , m_rng(seed)
+        , m_noise(0.0, 1.0)
+    {
+        reset(0.0);
+    }
+
+    void setModel(const AxisModel &model) { m_model = model; }
+    const AxisModel &model() const { return m_model; }
+
+    // Places the axis at rest; the gear play is centered
+    void reset(double position)
+    {
+        m_motorPos = position;
+        m_motorVel = 0.0;
+        m_gearPos = position;
+        m_loadPos = position;
+        m_loadVel = 0.0;
+        m_target = position;
+        m_jogVelocity = 0.0;
+        m_jogging = false;
+    }
+
+    // Point-to-point move; replaces any running move or jog
+    void moveTo(double target)
+    {
+        m_target = target;
+        m_jogging = false;
+    }
+
+    // Constant-velocity motion until moveTo() or stop()
+    void jog(double velocity)
+    {
+        m_jogVelocity = velocity;
+        m_jogging = true;
+    }
+
+    // Decelerates at the maximum rate and comes to rest
+    void stop()
+    {
+        moveTo(m_motorPos + stopDistance());
+    }
+
+    // Signed distance the motor travels while braking at the maximum rate
+    double stopDistance() const
+    {
+        double a = m_model.maxAcceleration;
+        return a > 0.0 ? m_motorVel * std::abs(m_motorVel) / (2.0 * a) : 0.0;
+    }
+
+    // True once the motor has reached its braking point for the current
+    // target. Retargeting from here passes the old target at speed.
+    bool isBlendable() const
+    {
+        double remaining = m_target - m_motorPos;
+        if (std::abs(remaining) <= m_model.settleToleranceDeg) {
+            return true;
+        }
+        return remaining * m_motorVel > 0.0
+            && std::abs(remaining) <= std::abs(stopDistance()) + m_model.settleToleranceDeg;
+    }
+
+    void step(double dt)
+    {
+        if (dt <= 0.0) {
+            return;
+        }
+        stepMotor(dt);
+        stepGear();
+        stepLoad(dt);
+    }
+
+    // Encoder reading of the load position
+    double readEncoder()
+    {
+        double reading = m_loadPos + m_model.encoderNoiseDeg * m_noise(m_rng);
+        double resolution = m_model.encoderResolutionDeg;
+        if (resolution > 0.0) {
+            reading = std::round(reading / resolution) * resolution;
+        }
+        return reading;
+    }
+
+    double target() const { return m_target; }
+    double motorPosition() const { return m_motorPos; }
+    double motorVelocity() const { return m_motorVel; }
+    double loadPosition() const { return m_loadPos; }
+    double loadVelocity() const { return m_loadVel; }
+    bool isJogging() const { return m_jogging; }
+
+    // Motor at its target and the load at rest within the tolerance of
+    // where the gear holds it
+    bool isSettled() const
+    {
+        double tolerance = m_model.settleToleranceDeg;
+        return !m_jogging && m_motorPos == m_target && m_motorVel == 0.0
+            && std::abs(m_loadPos - m_gearPos) <= tolerance
+            && std::abs(m_loadVel) <= tolerance * 10.0;
+    }
+
+private:
+    void stepMotor(double dt)
+    {
+        double a = m_model.maxAcceleration;
+        double vMax = m_model.maxVelocity;
+        double desired;
+        if (m_jogging) {
+            desired = std::max(-vMax, std::min(vMax, m_jogVelocity));
+        } else {
+            // Fastest velocity from which the target can still be reached
+            double error = m_target - m_motorPos;
+            desired = std::sqrt(2.0 * a * std::abs(error));
+            desired = std::min(vMax, desired) * (error < 0.0 ? -1.0 : 1.0);
+        }
+        double dv = desired - m_motorVel;
+        double maxDv = a * dt;
+        m_motorVel += std::max(-maxDv, std::min(maxDv, dv));
+
+        double next = m_motorPos + m_motorVel * dt;
+        // Land exactly on the target instead of dithering around it
+        if (!m_jogging && (next - m_target) * (m_motorPos - m_target) <= 0.0
+            && std::abs(m_motorVel) <= maxDv * 1.5) {
+            next = m_target;
+            m_motorVel = 0.0;
+        }
+        m_motorPos = next;
+    }
+
+    // The gear output only follows once the motor has taken up the play
+    void stepGear()
+    {
+        double halfPlay = m_model.backlashDeg / 2.0;
+        if (m_motorPos - m_gearPos > halfPlay) {
+            m_gearPos = m_motorPos - halfPlay;
+        } else if (m_gearPos - m_motorPos > halfPlay) {
+            m_gearPos = m_motorPos + halfPlay;
+        }
+    }
+
+    // Spring-damper load, sub-stepped to keep the integration stable
+    void stepLoad(double dt)
+    {
+        double wn = 2.0 * 3.14159265358979323846 * m_model.naturalFreqHz;
+        if (wn <= 0.0) {
+            m_loadVel = (m_gearPos - m_loadPos) / dt;
+            m_loadPos = m_gearPos;
+            return;
+        }
+        int substeps = static_cast<int>(std::ceil(wn * dt / 0.05));
+        double h = dt / substeps;
+        for (int i = 0; i < substeps; i++) {
+            double acceleration = wn * wn * (m_gearPos - m_loadPos) - 2.0 * m_model.damping * wn * m_loadVel;
+            m_loadVel += acceleration * h;
+            m_loadPos += m_loadVel * h;
+        }
+    }
+
+    AxisModel m_model;
+    std::mt19937 m_rng;
+    std::normal_distribution<double> m_noise;
+
+    double m_motorPos;
+    double m_motorVel;
+    double m_gearPos;
+    double m_loadPos;
+    double m_loadVel;
+    double m_target;
+    double m_jogVelocity;
+    bool m_jogging;
+};
+
+#endif // MOTIONMODEL_H
@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bounded lock-free multi-producer/single-consumer queue.
+//
+// Ring buffer of sequenced cells: a producer claims a slot with one CAS
+// on the tail, the consumer owns the head. Neither side blocks; push()
+// returns false when the queue is full and pop() when it is empty.
+// Capacity is rounded up to a power of two.
+template<typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity)
+        : m_head(0)
+        , m_tail(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells = std::vector<Cell>(size);
+        for (size_t i = 0; i < size; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Safe from any number of threads
+    bool push(const T &value)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = m_cells[position & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pushes count values into consecutive slots, or nothing if they do
+    // not all fit. Safe from any number of threads.
+    bool pushAll(const T *values, size_t count)
+    {
+        if (count == 0) {
+            return true;
+        }
+        if (count > capacity()) {
+            return false;
+        }
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            size_t sequence = m_cells[position & m_mask].sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                // The consumer frees slots in order, so the batch fits if
+                // its last slot is free
+                size_t last = position + count - 1;
+                size_t lastSequence = m_cells[last & m_mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(lastSequence) - static_cast<intptr_t>(last) < 0) {
+                    return false;
+                }
+                if (m_tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < count; i++) {
+                        Cell &cell = m_cells[(position + i) & m_mask];
+                        cell.value = values[i];
+                        cell.sequence.store(position + i + 1, std::memory_order_release);
+                    }
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    bool pop(T &value)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        Cell &cell = m_cells[position & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate while producers are active
+    bool empty() const
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        const Cell &cell = m_cells[position & m_mask];
+        return cell.sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+
+        Cell() : sequence(0), value() {}
+        Cell(const Cell &) : sequence(0), value() {}
+    };
+
+    std::vector<Cell> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,442 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef PLUGINMETRICS_H
+#define PLUGINMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Shared-memory metrics segment.
+//
+// Plugins and the host register named counters and gauges in a named
+// shared-memory segment; every update is a single atomic operation on the
+// mapped memory, so nothing on the measurement path takes a lock. Other
+// processes (see metrics_exporter.cpp) can map the same segment and
+// render it with PrometheusExporter (common/prometheusexporter.h).
+//
+// Registration is meant to happen at setup time: two threads registering
+// the same metric at the same moment may end up with two slots.
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "metrics need lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "metrics need lock-free 32-bit atomics");
+
+#define PLUGIN_METRICS_DEFAULT_SEGMENT "antenna_tester_metrics"
+
+enum class MetricKind : uint32_t {
+    Counter = 1,        // integer, monotonically increasing
+    FloatCounter = 2,   // floating point, monotonically increasing (e.g. seconds)
+    Gauge = 3           // floating point, arbitrary value
+};
+
+struct MetricSlot {
+    std::atomic<uint32_t> state;    // 0 = free, 1 = being written, 2 = ready
+    uint32_t kind;
+    std::atomic<uint64_t> value;    // integer value or bits of a double
+    char name[64];
+    char labels[120];               // e.g. instrument="SC5511A",method="setFreq"
+    char help[56];
+};
+
+struct MetricsSegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    std::atomic<uint32_t> used;
+    std::atomic<uint32_t> ready;
+    uint32_t reserved[11];
+};
+
+static_assert(sizeof(MetricSlot) == 256, "MetricSlot layout is shared between processes");
+static_assert(sizeof(MetricsSegmentHeader) == 64, "MetricsSegmentHeader layout is shared between processes");
+
+inline uint64_t metricDoubleToBits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double metricBitsToDouble(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Formats key="value" for a metrics label set, escaping the value
+inline std::string metricLabel(const std::string &key, const std::string &value)
+{
+    std::string escaped;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return key + "=\"" + escaped + "\"";
+}
+
+// Handle to an integer counter; a default-constructed handle is a no-op
+class MetricCounter
+{
+public:
+    MetricCounter() : m_value(nullptr) {}
+    explicit MetricCounter(std::atomic<uint64_t> *value) : m_value(value) {}
+
+    void add(uint64_t amount = 1)
+    {
+        if (m_value) {
+            m_value->fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t value() const { return m_value ? m_value->load(std::memory_order_relaxed) : 0; }
+    bool isValid() const { return m_value != nullptr; }
+
+private:
+    std::atomic<uint64_t> *m_value;
+};
+
+// Handle to a floating point counter or gauge; a default-constructed handle is a no-op
+class MetricGauge
+{
+public:
+    MetricGauge() : m_value(nullptr) {}
+    explicit MetricGauge(std::atomic<uint64_t> *value) : m_value(value) {}
+
+    void set(double value)
+    {
+        if (m_value) {
+            m_value->store(metricDoubleToBits(value), std::memory_order_relaxed);
+        }
+    }
+
+    void add(double amount)
+    {
+        if (!m_value) {
+            return;
+        }
+        uint64_t current = m_value->load(std::memory_order_relaxed);
+        while (!m_value->compare_exchange_weak(current,
+                   metricDoubleToBits(metricBitsToDouble(current) + amount),
+                   std::memory_order_relaxed)) {
+        }
+    }
+
+    double value() const { return m_value ? metricBitsToDouble(m_value->load(std::memory_order_relaxed)) : 0.0; }
+    bool isValid() const { return m_value != nullptr; }
+
+private:
+    std::atomic<uint64_t> *m_value;
+};
+
+class MetricsSegment
+{
+public:
+    static constexpr uint32_t Magic = 0x4D545246;   // "FRTM"
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t DefaultCapacity = 512;
+
+    MetricsSegment()
+        : m_header(nullptr)
+        , m_slots(nullptr)
+        , m_size(0)
+#ifdef _WIN32
+        , m_mapping(NULL)
+#endif
+    {
+    }
+
+    ~MetricsSegment()
+    {
+        close();
+    }
+
+    MetricsSegment(const MetricsSegment &) = delete;
+    MetricsSegment &operator=(const MetricsSegment &) = delete;
+
+    // Create the segment, or attach to it if it already exists
+    bool open(const std::string &name = PLUGIN_METRICS_DEFAULT_SEGMENT,
+              uint32_t capacity = DefaultCapacity)
+    {
+        return map(name, capacity, true);
+    }
+
+    // Attach to an existing segment only (used by external exporters)
+    bool attach(const std::string &name = PLUGIN_METRICS_DEFAULT_SEGMENT)
+    {
+        return map(name, 0, false);
+    }
+
+    void close()
+    {
+        if (!m_header) {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(m_header);
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+#else
+        munmap(m_header, m_size);
+#endif
+        m_header = nullptr;
+        m_slots = nullptr;
+        m_size = 0;
+    }
+
+    bool isOpen() const { return m_header != nullptr; }
+    const std::string &name() const { return m_name; }
+
+    // Remove the segment name from the system. Existing mappings stay
+    // valid. On Windows the segment disappears with its last handle.
+    static void unlink(const std::string &name = PLUGIN_METRICS_DEFAULT_SEGMENT)
+    {
+#ifndef _WIN32
+        shm_unlink(("/" + name).c_str());
+#else
+        (void)name;
+#endif
+    }
+
+    // Process-wide segment with the default name, opened on first use.
+    // Each plugin DLL has its own instance, all mapping the same memory.
+    static MetricsSegment &global()
+    {
+        static MetricsSegment segment;
+        static std::once_flag once;
+        std::call_once(once, []() {
+            if (!segment.open()) {
+                std::cerr << "[Metrics] Cannot open shared-memory segment "
+                          << PLUGIN_METRICS_DEFAULT_SEGMENT << std::endl;
+            }
+        });
+        return segment;
+    }
+
+    MetricCounter counter(const std::string &name, const std::string &labels = "",
+                          const std::string &help = "")
+    {
+        return MetricCounter(registerSlot(MetricKind::Counter, name, labels, help));
+    }
+
+    MetricGauge floatCounter(const std::string &name, const std::string &labels = "",
+                             const std::string &help = "")
+    {
+        return MetricGauge(registerSlot(MetricKind::FloatCounter, name, labels, help));
+    }
+
+    MetricGauge gauge(const std::string &name, const std::string &labels = "",
+                      const std::string &help = "")
+    {
+        return MetricGauge(registerSlot(MetricKind::Gauge, name, labels, help));
+    }
+
+    uint32_t capacity() const { return m_header ? m_header->capacity : 0; }
+
+    // Number of slots that can be read; each one is fully initialized
+    uint32_t slotCount() const
+    {
+        if (!m_header) {
+            return 0;
+        }
+        uint32_t used = m_header->used.load(std::memory_order_acquire);
+        return used < m_header->capacity ? used : m_header->capacity;
+    }
+
+    const MetricSlot *slot(uint32_t index) const
+    {
+        const MetricSlot *s = &m_slots[index];
+        return s->state.load(std::memory_order_acquire) == 2 ? s : nullptr;
+    }
+
+private:
+    std::atomic<uint64_t> *registerSlot(MetricKind kind, const std::string &name,
+                                        const std::string &labels, const std::string &help)
+    {
+        if (!m_header) {
+            return nullptr;
+        }
+
+        // Reuse an existing slot with the same name and labels
+        uint32_t count = slotCount();
+        for (uint32_t i = 0; i < count; i++) {
+            const MetricSlot *existing = slot(i);
+            if (existing && name == existing->name && labels == existing->labels) {
+                return &m_slots[i].value;
+            }
+        }
+
+        uint32_t index = m_header->used.fetch_add(1, std::memory_order_acq_rel);
+        if (index >= m_header->capacity) {
+            m_header->used.store(m_header->capacity, std::memory_order_release);
+            std::cerr << "[Metrics] Segment full, cannot register " << name << std::endl;
+            return nullptr;
+        }
+
+        MetricSlot &s = m_slots[index];
+        s.state.store(1, std::memory_order_relaxed);
+        s.kind = static_cast<uint32_t>(kind);
+        s.value.store(kind == MetricKind::Counter ? 0 : metricDoubleToBits(0.0), std::memory_order_relaxed);
+        copyText(s.name, sizeof(s.name), name);
+        copyText(s.labels, sizeof(s.labels), labels);
+        copyText(s.help, sizeof(s.help), help);
+        s.state.store(2, std::memory_order_release);
+        return &s.value;
+    }
+
+    static void copyText(char *dest, size_t size, const std::string &text)
+    {
+        size_t length = text.size() < size - 1 ? text.size() : size - 1;
+        std::memcpy(dest, text.data(), length);
+        dest[length] = '\0';
+    }
+
+    bool map(const std::string &name, uint32_t capacity, bool create)
+    {
+        close();
+        m_name = name;
+
+        size_t size = create ? sizeof(MetricsSegmentHeader) + capacity * sizeof(MetricSlot) : 0;
+        bool creator = false;
+        void *memory = nullptr;
+
+#ifdef _WIN32
+        std::string mappingName = "Local\\" + name;
+        if (create) {
+            m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                           0, static_cast<DWORD>(size), mappingName.c_str());
+            creator = (m_mapping != NULL && GetLastError() != ERROR_ALREADY_EXISTS);
+        } else {
+            m_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName.c_str());
+        }
+        if (m_mapping == NULL) {
+            return false;
+        }
+        memory = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (memory == NULL) {
+            CloseHandle(m_mapping);
+            m_mapping = NULL;
+            return false;
+        }
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(memory, &info, sizeof(info));
+        size = info.RegionSize;
+#else
+        std::string shmName = "/" + name;
+        int fd = -1;
+        if (create) {
+            fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd >= 0) {
+                creator = true;
+                if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                    ::close(fd);
+                    shm_unlink(shmName.c_str());
+                    return false;
+                }
+            }
+        }
+        if (fd < 0) {
+            fd = shm_open(shmName.c_str(), O_RDWR, 0644);
+            if (fd < 0) {
+                return false;
+            }
+            // The creator may still be sizing the segment
+            struct stat st;
+            for (int retry = 0; retry < 100; retry++) {
+                if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            size = static_cast<size_t>(st.st_size);
+        }
+        if (size < sizeof(MetricsSegmentHeader)) {
+            ::close(fd);
+            return false;
+        }
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+#endif
+
+        m_header = static_cast<MetricsSegmentHeader*>(memory);
+        m_slots = reinterpret_cast<MetricSlot*>(m_header + 1);
+        m_size = size;
+
+        if (creator) {
+            m_header->version = Version;
+            m_header->capacity = capacity;
+            m_header->used.store(0, std::memory_order_relaxed);
+            m_header->ready.store(Magic, std::memory_order_release);
+            m_header->magic = Magic;
+        } else {
+            for (int retry = 0; retry < 100 && m_header->ready.load(std::memory_order_acquire) != Magic; retry++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            uint32_t maxSlots = static_cast<uint32_t>((size - sizeof(MetricsSegmentHeader)) / sizeof(MetricSlot));
+            if (m_header->ready.load(std::memory_order_acquire) != Magic ||
+                m_header->version != Version || m_header->capacity > maxSlots) {
+                std::cerr << "[Metrics] Segment " << name << " has an incompatible layout" << std::endl;
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string m_name;
+    MetricsSegmentHeader *m_header;
+    MetricSlot *m_slots;
+    size_t m_size;
+#ifdef _WIN32
+    HANDLE m_mapping;
+#endif
+};
+
+#endif // PLUGINMETRICS_H
@@ -0,0 +1,248 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef POWERSWEEP_H
+#define POWERSWEEP_H
+
+#include "iplugininterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// Power sweep and compression point search.
+//
+// The generator level is stepped from startdBm in coarseStepdB steps and
+// the analyzer output read at each step (the caller tunes both to the test
+// frequency). The small-signal gain is the mean gain of the first
+// smallSignalPoints steps. The coarse sweep stops at the first level
+// compressed by compressiondB or more; the compression point is then
+// bracketed and bisected until the bracket is narrower than tolerancedB,
+// and interpolated linearly inside the final bracket. That costs the
+// coarse steps up to compression plus log2(coarseStepdB / tolerancedB)
+// points, where a sweep at the tolerance resolution would take
+// (stop - start) / tolerancedB.
+//
+// Afterwards the generator is returned to its level from before the sweep
+// (getPower()); plugins that do not report it are left at the lowest level
+// of the sweep, so a compressed DUT is not kept overdriven. Input levels
+// are generator levels; the caller corrects for cable loss by offsetting
+// the result.
+
+struct PowerSweepSettings {
+    double startdBm;
+    double stopdBm;
+    double coarseStepdB;
+    double compressiondB;       // 1.0 for P1dB
+    double tolerancedB;         // input level resolution of the search
+    int smallSignalPoints;
+
+    PowerSweepSettings()
+        : startdBm(-30.0)
+        , stopdBm(10.0)
+        , coarseStepdB(2.0)
+        , compressiondB(1.0)
+        , tolerancedB(0.05)
+        , smallSignalPoints(3)
+    {}
+};
+
+struct PowerSweepPoint {
+    double inputdBm;
+    double outputdBm;
+    double gaindB;
+
+    PowerSweepPoint() : inputdBm(0.0), outputdBm(0.0), gaindB(0.0) {}
+    PowerSweepPoint(double input, double output) : inputdBm(input), outputdBm(output), gaindB(output - input) {}
+};
+
+struct CompressionResult {
+    bool ok;                    // every measurement succeeded
+    bool found;                 // compression reached within the sweep range
+    double smallSignalGaindB;
+    double inputCompressiondBm;
+    double outputCompressiondBm;
+    std::vector<PowerSweepPoint> points;    // sorted by input level
+    size_t measurements;
+    double elapsedS;
+
+    CompressionResult()
+        : ok(false)
+        , found(false)
+        , smallSignalGaindB(0.0)
+        , inputCompressiondBm(0.0)
+        , outputCompressiondBm(0.0)
+        , measurements(0)
+        , elapsedS(0.0)
+    {}
+};
+
+class PowerSweep
+{
+public:
+    // Bound on the bisection, far beyond what a sensible tolerance needs
+    static constexpr int MaxBisectionSteps = 30;
+
+    PowerSweep(ISignalGeneratorPlugin &generator, ISignalAnalyzerPlugin &analyzer)
+        : m_generator(generator)
+        , m_analyzer(analyzer)
+        , m_currentdBm(std::nan(""))
+        , m_restoredBm(0.0)
+        , m_hasRestoreLevel(false)
+    {
+    }
+
+    // Output at each level of levelsdBm, in order
+    bool sweep(const std::vector<double> &levelsdBm, std::vector<PowerSweepPoint> &points)
+    {
+        points.clear();
+        if (levelsdBm.empty()) {
+            return true;
+        }
+        bool rfWasEnabled = prepare();
+        bool ok = true;
+        for (double level : levelsdBm) {
+            PowerSweepPoint point;
+            if (!measure(level, point)) {
+                ok = false;
+                break;
+            }
+            points.push_back(point);
+        }
+        finish(*std::min_element(levelsdBm.begin(), levelsdBm.end()), rfWasEnabled);
+        return ok;
+    }
+
+    CompressionResult findCompression(const PowerSweepSettings &settings)
+    {
+        CompressionResult result;
+        auto startTime = std::chrono::steady_clock::now();
+        if (!(settings.coarseStepdB > 0.0) || !(settings.tolerancedB > 0.0) ||
+            !(settings.stopdBm >= settings.startdBm)) {
+            return result;
+        }
+        bool rfWasEnabled = prepare();
+        result.ok = true;
+
+        // Coarse sweep up to the first compressed level
+        PowerSweepPoint below;
+        PowerSweepPoint above;
+        double gainSum = 0.0;
+        int gainCount = 0;
+        int steps = (int)std::floor((settings.stopdBm - settings.startdBm) / settings.coarseStepdB + 1e-9);
+        for (int i = 0; i <= steps; i++) {
+            PowerSweepPoint point;
+            if (!measure(settings.startdBm + i * settings.coarseStepdB, point)) {
+                result.ok = false;
+                break;
+            }
+            result.points.push_back(point);
+            if (gainCount < std::max(settings.smallSignalPoints, 1)) {
+                gainSum += point.gaindB;
+                gainCount++;
+                result.smallSignalGaindB = gainSum / gainCount;
+            }
+            if (result.smallSignalGaindB - point.gaindB >= settings.compressiondB && i > 0) {
+                above = point;
+                result.found = true;
+                break;
+            }
+            below = point;
+        }
+
+        // Bisect the bracket
+        if (result.found) {
+            for (int step = 0; step < MaxBisectionSteps && above.inputdBm - below.inputdBm > settings.tolerancedB; step++) {
+                PowerSweepPoint point;
+                if (!measure((below.inputdBm + above.inputdBm) / 2.0, point)) {
+                    result.ok = false;
+                    break;
+                }
+                result.points.push_back(point);
+                if (result.smallSignalGaindB - point.gaindB >= settings.compressiondB) {
+                    above = point;
+                } else {
+                    below = point;
+                }
+            }
+            double c0 = result.smallSignalGaindB - below.gaindB;
+            double c1 = result.smallSignalGaindB - above.gaindB;
+            double t = c1 > c0 ? (settings.compressiondB - c0) / (c1 - c0) : 0.0;
+            t = std::min(std::max(t, 0.0), 1.0);
+            result.inputCompressiondBm = below.inputdBm + t * (above.inputdBm - below.inputdBm);
+            result.outputCompressiondBm = result.inputCompressiondBm + result.smallSignalGaindB - settings.compressiondB;
+        }
+
+        finish(settings.startdBm, rfWasEnabled);
+        std::sort(result.points.begin(), result.points.end(),
+                  [](const PowerSweepPoint &a, const PowerSweepPoint &b) { return a.inputdBm < b.inputdBm; });
+        result.measurements = result.points.size();
+        result.elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+
+private:
+    bool prepare()
+    {
+        bool rfWasEnabled = m_generator.isRfEnabled();
+        m_hasRestoreLevel = m_generator.getPower(m_restoredBm);
+        m_currentdBm = std::nan("");
+        return rfWasEnabled;
+    }
+
+    // fallbackdBm is used when the generator did not report its level
+    void finish(double fallbackdBm, bool rfWasEnabled)
+    {
+        m_generator.setPower(m_hasRestoreLevel ? m_restoredBm : fallbackdBm);
+        if (!rfWasEnabled && m_generator.isRfEnabled()) {
+            m_generator.disableRf();
+        }
+    }
+
+    // One generator round trip (skipped if the level is already set) and
+    // one analyzer round trip
+    bool measure(double leveldBm, PowerSweepPoint &point)
+    {
+        if (!(leveldBm == m_currentdBm)) {
+            m_generator.setPower(leveldBm);
+            m_currentdBm = leveldBm;
+        }
+        if (!m_generator.isRfEnabled()) {
+            m_generator.enableRf();
+        }
+        Peak peak = m_analyzer.findPeak();
+        if (peak.frequencyHz == 0.0) {
+            return false;
+        }
+        point = PowerSweepPoint(leveldBm, peak.leveldBm);
+        return true;
+    }
+
+    ISignalGeneratorPlugin &m_generator;
+    ISignalAnalyzerPlugin &m_analyzer;
+    double m_currentdBm;
+    double m_restoredBm;
+    bool m_hasRestoreLevel;
+};
+
+#endif // POWERSWEEP_H
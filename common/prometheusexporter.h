@@ -0,0 +1,304 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef PROMETHEUSEXPORTER_H
+#define PROMETHEUSEXPORTER_H
+
+// winsock2.h has to be included before Windows.h (pulled in by pluginmetrics.h)
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "common/pluginmetrics.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Renders a metrics segment in the Prometheus text exposition format and
+// publishes it to a file (for the node_exporter textfile collector) or on
+// a local HTTP port. Reading the segment never blocks the writers.
+class PrometheusExporter
+{
+public:
+    explicit PrometheusExporter(const MetricsSegment &segment)
+        : m_segment(segment)
+        , m_running(false)
+    {
+    }
+
+    ~PrometheusExporter()
+    {
+        stop();
+    }
+
+    std::string render() const
+    {
+        // Group samples by metric name so HELP/TYPE appear once per family
+        struct Family {
+            uint32_t kind;
+            std::string help;
+            std::vector<std::string> samples;
+        };
+        std::map<std::string, Family> families;
+
+        uint32_t count = m_segment.slotCount();
+        for (uint32_t i = 0; i < count; i++) {
+            const MetricSlot *slot = m_segment.slot(i);
+            if (!slot) {
+                continue;
+            }
+            Family &family = families[slot->name];
+            family.kind = slot->kind;
+            if (family.help.empty()) {
+                family.help = slot->help;
+            }
+
+            std::ostringstream sample;
+            sample << slot->name;
+            if (slot->labels[0] != '\0') {
+                sample << "{" << slot->labels << "}";
+            }
+            uint64_t raw = slot->value.load(std::memory_order_relaxed);
+            if (slot->kind == static_cast<uint32_t>(MetricKind::Counter)) {
+                sample << " " << raw;
+            } else {
+                char number[32];
+                std::snprintf(number, sizeof(number), "%.9g", metricBitsToDouble(raw));
+                sample << " " << number;
+            }
+            family.samples.push_back(sample.str());
+        }
+
+        std::ostringstream text;
+        for (const auto &entry : families) {
+            if (!entry.second.help.empty()) {
+                text << "# HELP " << entry.first << " " << entry.second.help << "\n";
+            }
+            text << "# TYPE " << entry.first << " "
+                 << (entry.second.kind == static_cast<uint32_t>(MetricKind::Gauge) ? "gauge" : "counter") << "\n";
+            for (const std::string &sample : entry.second.samples) {
+                text << sample << "\n";
+            }
+        }
+        return text.str();
+    }
+
+    // Write atomically (temporary file + rename)
+    bool writeFile(const std::string &path) const
+    {
+        std::string temporary = path + ".tmp";
+        FILE *file = std::fopen(temporary.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        std::string text = render();
+        bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+#ifdef _WIN32
+        return MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+    // Rewrite the file every interval on a background thread
+    bool startFileExport(const std::string &path, std::chrono::milliseconds interval)
+    {
+        stop();
+        m_running = true;
+        m_thread = std::thread([this, path, interval]() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (m_running) {
+                if (!writeFile(path)) {
+                    std::cerr << "[Metrics] Cannot write " << path << std::endl;
+                }
+                m_wake.wait_for(lock, interval, [this]() { return !m_running; });
+            }
+        });
+        return true;
+    }
+
+    // Serve GET requests on 127.0.0.1:port on a background thread
+    bool startHttpExport(unsigned short port)
+    {
+        stop();
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            return false;
+        }
+#endif
+        SocketHandle listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == InvalidSocket) {
+            socketCleanup();
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, 4) != 0) {
+            closeSocket(listener);
+            socketCleanup();
+            return false;
+        }
+
+        m_running = true;
+        m_thread = std::thread([this, listener]() {
+            while (m_running) {
+                // Poll with a timeout so stop() is honoured promptly
+                fd_set readSet;
+                FD_ZERO(&readSet);
+                FD_SET(listener, &readSet);
+                timeval timeout;
+                timeout.tv_sec = 0;
+                timeout.tv_usec = 200000;
+                if (select(static_cast<int>(listener) + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+                    continue;
+                }
+                SocketHandle client = accept(listener, nullptr, nullptr);
+                if (client == InvalidSocket) {
+                    continue;
+                }
+                // An idle client must not hold the thread: wait for the
+                // request in short slices and give up after ClientTimeoutMs
+                if (!waitForRequest(client)) {
+                    closeSocket(client);
+                    continue;
+                }
+                char request[1024];
+                recv(client, request, sizeof(request), 0);
+
+                std::string body = render();
+                std::ostringstream response;
+                response << "HTTP/1.0 200 OK\r\n"
+                         << "Content-Type: text/plain; version=0.0.4\r\n"
+                         << "Content-Length: " << body.size() << "\r\n"
+                         << "Connection: close\r\n\r\n"
+                         << body;
+                std::string data = response.str();
+                send(client, data.data(), static_cast<int>(data.size()), 0);
+                closeSocket(client);
+            }
+            closeSocket(listener);
+            socketCleanup();
+        });
+        return true;
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    static constexpr int ClientTimeoutMs = 2000;
+
+#ifdef _WIN32
+    typedef SOCKET SocketHandle;
+    static constexpr SocketHandle InvalidSocket = INVALID_SOCKET;
+    static void closeSocket(SocketHandle s) { closesocket(s); }
+    static void socketCleanup() { WSACleanup(); }
+#else
+    typedef int SocketHandle;
+    static constexpr SocketHandle InvalidSocket = -1;
+    static void closeSocket(SocketHandle s) { ::close(s); }
+    static void socketCleanup() {}
+#endif
+
+    // True once the client has sent data; false on timeout or stop()
+    bool waitForRequest(SocketHandle client)
+    {
+        // Backstop for send() to a client that stops reading
+#ifdef _WIN32
+        DWORD sendTimeout = ClientTimeoutMs;
+#else
+        timeval sendTimeout;
+        sendTimeout.tv_sec = ClientTimeoutMs / 1000;
+        sendTimeout.tv_usec = (ClientTimeoutMs % 1000) * 1000;
+#endif
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&sendTimeout), sizeof(sendTimeout));
+
+        for (int waitedMs = 0; waitedMs < ClientTimeoutMs && m_running; waitedMs += 200) {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(client, &readSet);
+            timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 200000;
+            int ready = select(static_cast<int>(client) + 1, &readSet, nullptr, nullptr, &timeout);
+            if (ready < 0) {
+                return false;
+            }
+            if (ready > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const MetricsSegment &m_segment;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+#endif // PROMETHEUSEXPORTER_H
@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef SCALARNETWORKANALYSIS_H
+#define SCALARNETWORKANALYSIS_H
+
+#include "iplugininterface.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Swept S21 magnitude with a generator and an analyzer ("tracking
+// generator" mode).
+//
+// Every frequency point is measured with a narrow analyzer span centered
+// on the generator frequency. Two pacing strategies are used:
+//   - List: the generator runs a hardware list sweep and its trigger out
+//     starts each analyzer sweep. This needs the generator trigger out
+//     wired to the analyzer trigger in (settings.triggerWired) and plugins
+//     that support both; the analyzer is retuned for the next point while
+//     the generator dwells on the current one.
+//   - Stepped: the host retunes the generator (hop table if the plugin has
+//     one, else setFreq) on a helper thread while the analyzer is
+//     reconfigured, then measures.
+// If the list sweep loses step (a missed trigger), the remaining points
+// are measured stepped.
+//
+// S21 is received level - source power - reference, where the reference
+// is a through (or reference antenna) measurement stored with
+// setReference(), interpolated linearly in frequency. The analyzer is left
+// at the span and RBW of the last point.
+
+struct S21SweepSettings {
+    std::vector<double> freqsHz;
+    double sourcePowerdBm;
+    double spanHz;              // analyzer span per point
+    double rbwHz;
+    bool useListMode;
+    bool triggerWired;          // generator trigger out -> analyzer trigger in
+    double dwellS;              // list dwell per point, 0 = from the first point
+    double triggerTimeoutS;
+
+    S21SweepSettings()
+        : sourcePowerdBm(0.0)
+        , spanHz(200e3)
+        , rbwHz(10e3)
+        , useListMode(true)
+        , triggerWired(false)
+        , dwellS(0.0)
+        , triggerTimeoutS(1.0)
+    {}
+};
+
+struct S21Trace {
+    bool ok;
+    bool normalized;            // a reference was subtracted
+    size_t listPoints;          // points paced by the hardware list
+    double elapsedS;
+    std::vector<double> freqsHz;
+    std::vector<double> s21dB;
+    std::vector<double> receiveddBm;
+    std::vector<uint64_t> timestampNs;
+    // Peak within tolerance of the generator frequency; false means the
+    // analyzer saw the wrong tone or none
+    std::vector<bool> valid;
+
+    S21Trace() : ok(false), normalized(false), listPoints(0), elapsedS(0.0) {}
+};
+
+class ScalarNetworkAnalyzer
+{
+public:
+    // Safety factor on the measured point time for the automatic dwell
+    static constexpr double DwellMargin = 1.5;
+
+    ScalarNetworkAnalyzer(ISignalGeneratorPlugin &generator, ISignalAnalyzerPlugin &analyzer)
+        : m_generator(generator)
+        , m_analyzer(analyzer)
+    {
+    }
+
+    // Through or reference-antenna sweep; its S21 is subtracted from every
+    // later sweep
+    void setReference(const S21Trace &through)
+    {
+        std::vector<std::pair<double, double>> points;
+        for (size_t i = 0; i < through.freqsHz.size(); i++) {
+            if (through.valid[i]) {
+                points.push_back(std::make_pair(through.freqsHz[i], through.s21dB[i]));
+            }
+        }
+        std::sort(points.begin(), points.end());
+        m_referenceFreqsHz.clear();
+        m_referencedB.clear();
+        for (const auto &point : points) {
+            m_referenceFreqsHz.push_back(point.first);
+            m_referencedB.push_back(point.second);
+        }
+    }
+
+    void clearReference()
+    {
+        m_referenceFreqsHz.clear();
+        m_referencedB.clear();
+    }
+
+    bool hasReference() const { return !m_referenceFreqsHz.empty(); }
+
+    S21Trace sweep(const S21SweepSettings &settings)
+    {
+        S21Trace result;
+        size_t count = settings.freqsHz.size();
+        if (count == 0 || !m_generator.isConnected() || !m_analyzer.isConnected()) {
+            return result;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        result.freqsHz = settings.freqsHz;
+        result.s21dB.assign(count, 0.0);
+        result.receiveddBm.assign(count, 0.0);
+        result.timestampNs.assign(count, 0);
+        result.valid.assign(count, false);
+
+        bool rfWasEnabled = m_generator.isRfEnabled();
+        m_generator.setPower(settings.sourcePowerdBm);
+        m_analyzer.setRBW(settings.rbwHz);
+
+        // The first point is always stepped; it also times the analyzer
+        // for the automatic list dwell
+        m_generator.setFreq(settings.freqsHz[0]);
+        if (!rfWasEnabled) {
+            m_generator.enableRf();
+        }
+        auto pointStart = std::chrono::steady_clock::now();
+        measure(settings, 0, result);
+        double pointS = std::chrono::duration<double>(std::chrono::steady_clock::now() - pointStart).count();
+
+        size_t next = 1;
+        if (next < count && settings.useListMode && settings.triggerWired) {
+            double dwellS = settings.dwellS > 0.0 ? settings.dwellS : pointS * DwellMargin;
+            next = sweepList(settings, dwellS, result);
+        }
+        if (next < count) {
+            sweepStepped(settings, next, result);
+        }
+
+        if (!rfWasEnabled) {
+            m_generator.disableRf();
+        }
+
+        result.normalized = hasReference();
+        for (size_t i = 0; i < count; i++) {
+            result.s21dB[i] = result.receiveddBm[i] - settings.sourcePowerdBm - referencedB(result.freqsHz[i]);
+        }
+        result.ok = std::find(result.valid.begin(), result.valid.end(), false) == result.valid.end();
+        result.elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return result;
+    }
+
+private:
+    double referencedB(double freqHz) const
+    {
+        size_t n = m_referenceFreqsHz.size();
+        if (n == 0) {
+            return 0.0;
+        }
+        auto upper = std::lower_bound(m_referenceFreqsHz.begin(), m_referenceFreqsHz.end(), freqHz);
+        if (upper == m_referenceFreqsHz.begin()) {
+            return m_referencedB.front();
+        }
+        if (upper == m_referenceFreqsHz.end()) {
+            return m_referencedB.back();
+        }
+        size_t i = upper - m_referenceFreqsHz.begin();
+        double f0 = m_referenceFreqsHz[i - 1];
+        double f1 = m_referenceFreqsHz[i];
+        double t = f1 > f0 ? (freqHz - f0) / (f1 - f0) : 0.0;
+        return m_referencedB[i - 1] + t * (m_referencedB[i] - m_referencedB[i - 1]);
+    }
+
+    void tuneAnalyzer(const S21SweepSettings &settings, size_t index)
+    {
+        double center = settings.freqsHz[index];
+        m_analyzer.setStartFreq(center - settings.spanHz / 2.0);
+        m_analyzer.setStopFreq(center + settings.spanHz / 2.0);
+    }
+
+    // Analyzer is tuned and the generator is on the point
+    bool readPoint(const S21SweepSettings &settings, size_t index, S21Trace &result)
+    {
+        Peak peak = m_analyzer.findPeak();
+        if (peak.frequencyHz == 0.0) {
+            return false;
+        }
+        double tolerance = std::max(2.0 * settings.rbwHz, settings.spanHz / 50.0);
+        result.receiveddBm[index] = peak.leveldBm;
+        result.timestampNs[index] = peak.timestampNs;
+        result.valid[index] = std::abs(peak.frequencyHz - settings.freqsHz[index]) <= tolerance;
+        return true;
+    }
+
+    bool measure(const S21SweepSettings &settings, size_t index, S21Trace &result)
+    {
+        tuneAnalyzer(settings, index);
+        return readPoint(settings, index, result);
+    }
+
+    // Hardware list from point 1 on. Returns the first point not measured.
+    size_t sweepList(const S21SweepSettings &settings, double dwellS, S21Trace &result)
+    {
+        std::vector<double> list(settings.freqsHz.begin() + 1, settings.freqsHz.end());
+        if (!m_generator.loadFreqList(list) || !m_generator.setTriggerIn(TriggerInMode::Software) ||
+            !m_generator.setTriggerOut(TriggerOutMode::EveryStep)) {
+            m_generator.setTriggerOut(TriggerOutMode::Off);
+            return 1;
+        }
+        if (!m_analyzer.setTriggerIn(TriggerInMode::StartSweep, std::max(settings.triggerTimeoutS, 2.0 * dwellS))) {
+            m_generator.setTriggerOut(TriggerOutMode::Off);
+            return 1;
+        }
+
+        size_t next = 1;
+        tuneAnalyzer(settings, next);
+        if (m_generator.startFreqList(dwellS, 1)) {
+            while (next < settings.freqsHz.size() && readPoint(settings, next, result) && result.valid[next]) {
+                next++;
+                if (next < settings.freqsHz.size()) {
+                    tuneAnalyzer(settings, next);
+                }
+            }
+            result.listPoints = next - 1;
+        }
+
+        m_analyzer.setTriggerIn(TriggerInMode::Software, 0.0);
+        m_generator.stopFreqList();
+        m_generator.setTriggerOut(TriggerOutMode::Off);
+        return next;
+    }
+
+    // Host-paced points from first on; the generator retunes on a helper
+    // thread while the analyzer is reconfigured
+    void sweepStepped(const S21SweepSettings &settings, size_t first, S21Trace &result)
+    {
+        const size_t count = settings.freqsHz.size();
+        bool hopTable = m_generator.loadHopTable(settings.freqsHz);
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t requested = first;      // point the generator should tune to
+        size_t tuned = first - 1;      // point the generator is on
+        bool quit = false;
+        std::thread retune([&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                condition.wait(lock, [&]() { return quit || requested != tuned; });
+                if (quit) {
+                    return;
+                }
+                size_t index = requested;
+                lock.unlock();
+                if (!hopTable || !m_generator.hopTo(index)) {
+                    m_generator.setFreq(settings.freqsHz[index]);
+                }
+                lock.lock();
+                tuned = index;
+                condition.notify_all();
+            }
+        });
+
+        for (size_t i = first; i < count; i++) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                requested = i;
+            }
+            condition.notify_all();
+            tuneAnalyzer(settings, i);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return tuned == i; });
+            }
+            readPoint(settings, i, result);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        condition.notify_all();
+        retune.join();
+    }
+
+    ISignalGeneratorPlugin &m_generator;
+    ISignalAnalyzerPlugin &m_analyzer;
+    std::vector<double> m_referenceFreqsHz;
+    std::vector<double> m_referencedB;
+};
+
+#endif // SCALARNETWORKANALYSIS_H
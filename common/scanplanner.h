@@ -0,0 +1,497 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef SCANPLANNER_H
+#define SCANPLANNER_H
+
+#include "iplugininterface.h"
+#include "common/motionmodel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Measurement-order planner for angle x frequency scans.
+//
+// A scan visits every (angle, frequency) pair once. How long it takes
+// depends almost entirely on the order: retuning a generator costs
+// milliseconds, moving a positioner costs seconds. ScanPlanner evaluates a
+// set of candidate orderings against cost models of the positioner,
+// generator and analyzer and returns the fastest one together with the
+// predicted duration of every step.
+//
+// Usage:
+//     PositionerCostModel motion = PositionerCostModel::fromSettings(step, movement);
+//     GeneratorCostModel tuning;           // defaults fit a synthesizer
+//     ScanPlanner planner(motion, tuning, 0.05);
+//     ScanPlan plan = planner.plan(ScanGrid::make(-90, 90, 5, 0, 30, 10), freqs);
+//     for (const ScanStep& s : plan.steps) { ... }
+
+// One angle of the scan grid
+struct ScanAngle {
+    double az;
+    double el;
+    double pol;
+};
+
+// Rectangular angle grid; polarization is constant over the grid
+struct ScanGrid {
+    std::vector<double> az;
+    std::vector<double> el;
+    double pol = 0.0;
+
+    static ScanGrid make(double azStart, double azStop, double azStep,
+                         double elStart, double elStop, double elStep, double pol = 0.0)
+    {
+        ScanGrid grid;
+        grid.az = range(azStart, azStop, azStep);
+        grid.el = range(elStart, elStop, elStep);
+        grid.pol = pol;
+        return grid;
+    }
+
+    size_t size() const { return az.size() * el.size(); }
+
+    static std::vector<double> range(double start, double stop, double step)
+    {
+        std::vector<double> values;
+        if (step <= 0.0) {
+            values.push_back(start);
+            return values;
+        }
+        double direction = stop >= start ? 1.0 : -1.0;
+        size_t count = static_cast<size_t>(std::floor(std::abs(stop - start) / step + 1e-9)) + 1;
+        for (size_t i = 0; i < count; i++) {
+            values.push_back(start + direction * step * static_cast<double>(i));
+        }
+        return values;
+    }
+};
+
+// Motion cost of one positioner axis
+struct AxisCostModel {
+    double velocity = 10.0;         // deg/s
+    double acceleration = 0.0;      // deg/s^2, 0 = instantaneous
+    double settleS = 0.0;           // after every move of this axis
+    double backlashDeg = 0.0;       // lost motion on reversal
+    double approachDirection = 1.0; // +1/-1, direction final approaches are made from
+
+    double travelTime(double distance) const
+    {
+        distance = std::abs(distance);
+        if (distance <= 0.0 || velocity <= 0.0) {
+            return 0.0;
+        }
+        if (acceleration <= 0.0) {
+            return distance / velocity;
+        }
+        // Trapezoidal profile, triangular for short moves
+        double rampDistance = velocity * velocity / acceleration;
+        if (distance >= rampDistance) {
+            return distance / velocity + velocity / acceleration;
+        }
+        return 2.0 * std::sqrt(distance / acceleration);
+    }
+};
+
+struct PositionerCostModel {
+    AxisCostModel az;
+    AxisCostModel el;
+    AxisCostModel pol;
+    bool simultaneousAxes = true;   // axes move together (time = slowest axis)
+    double commandOverheadS = 0.0;  // per moveTo(), e.g. bus round trip
+
+    // Positioners that move one Step per control tick. The sign of
+    // Movement gives the direction final approaches are made from when
+    // backlash is set.
+    static PositionerCostModel fromSettings(const Step &step, const Movement &movement,
+                                            double tickSeconds = 0.1)
+    {
+        PositionerCostModel model;
+        model.az.velocity = std::abs(step.AZ) / tickSeconds;
+        model.el.velocity = std::abs(step.EL) / tickSeconds;
+        model.pol.velocity = std::abs(step.POL) / tickSeconds;
+        model.az.approachDirection = movement.AZ < 0.0 ? -1.0 : 1.0;
+        model.el.approachDirection = movement.EL < 0.0 ? -1.0 : 1.0;
+        model.pol.approachDirection = movement.POL < 0.0 ? -1.0 : 1.0;
+        // A move always takes at least one tick
+        model.commandOverheadS = tickSeconds;
+        return model;
+    }
+
+    // Positioners described by a mechanical model (e.g. the dummy
+    // positioner). Settling is estimated as four time constants of the
+    // load resonance.
+    static PositionerCostModel fromAxisModels(const AxisModel &az, const AxisModel &el, const AxisModel &pol)
+    {
+        PositionerCostModel model;
+        model.az = axisCost(az);
+        model.el = axisCost(el);
+        model.pol = axisCost(pol);
+        return model;
+    }
+
+private:
+    static AxisCostModel axisCost(const AxisModel &axis)
+    {
+        AxisCostModel cost;
+        cost.velocity = axis.maxVelocity;
+        cost.acceleration = axis.maxAcceleration;
+        cost.backlashDeg = axis.backlashDeg;
+        double wn = 2.0 * 3.14159265358979323846 * axis.naturalFreqHz;
+        if (wn > 0.0 && axis.damping > 0.0) {
+            cost.settleS = 4.0 / (axis.damping * wn);
+        }
+        return cost;
+    }
+};
+
+struct GeneratorCostModel {
+    double settleS = 0.002;         // fixed cost of any frequency change
+    double perGHzS = 0.0;           // additional cost per GHz of frequency jump
+    bool tuneDuringMotion = true;   // retune can overlap the positioner move
+
+    double retuneTime(double fromHz, double toHz) const
+    {
+        if (fromHz == toHz) {
+            return 0.0;
+        }
+        return settleS + perGHzS * std::abs(toHz - fromHz) / 1e9;
+    }
+};
+
+// One measurement of the plan
+struct ScanStep {
+    ScanAngle angle;
+    double freqHz;
+    bool move;                  // moveTo() needed before this step
+    bool approach;              // first move to approachAngle (backlash take-up)
+    ScanAngle approachAngle;
+    double startS;              // predicted start, relative to the scan start
+    double moveS;
+    double tuneS;
+    double measureS;
+};
+
+struct ScanPlan {
+    std::string strategy;
+    std::vector<ScanStep> steps;
+    double durationS = 0.0;
+    double moveS = 0.0;         // time attributed to positioner moves
+    double tuneS = 0.0;         // retune time not hidden behind a move
+    double measureS = 0.0;
+};
+
+class ScanPlanner
+{
+public:
+    // Above this many angles the 2-opt pass of the tour strategy is skipped
+    static constexpr size_t MaxTwoOptAngles = 2000;
+
+    ScanPlanner(const PositionerCostModel &positioner, const GeneratorCostModel &generator,
+                double measureS)
+        : m_positioner(positioner)
+        , m_generator(generator)
+        , m_measureS(measureS)
+    {
+    }
+
+    // Best of all grid strategies and the free tour
+    ScanPlan plan(const ScanGrid &grid, const std::vector<double> &freqsHz,
+                  const ScanAngle &startAngle = ScanAngle{0.0, 0.0, 0.0}) const
+    {
+        std::vector<ScanPlan> candidates = candidatePlans(grid, freqsHz, startAngle);
+        size_t best = 0;
+        for (size_t i = 1; i < candidates.size(); i++) {
+            if (candidates[i].durationS < candidates[best].durationS) {
+                best = i;
+            }
+        }
+        return candidates.empty() ? ScanPlan() : candidates[best];
+    }
+
+    // Arbitrary angle sets (e.g. adaptive refinement): nearest neighbour + 2-opt
+    ScanPlan plan(const std::vector<ScanAngle> &angles, const std::vector<double> &freqsHz,
+                  const ScanAngle &startAngle = ScanAngle{0.0, 0.0, 0.0}) const
+    {
+        ScanPlan tour = evaluate("tour, frequency inner", orderTour(angles, startAngle),
+                                 freqsHz, true, startAngle);
+        ScanPlan given = evaluate("given order, frequency inner", angles, freqsHz, true, startAngle);
+        return tour.durationS <= given.durationS ? tour : given;
+    }
+
+    // Every strategy, including the plain nested loops used as baseline
+    std::vector<ScanPlan> candidatePlans(const ScanGrid &grid, const std::vector<double> &freqsHz,
+                                         const ScanAngle &startAngle = ScanAngle{0.0, 0.0, 0.0}) const
+    {
+        std::vector<ScanPlan> plans;
+        if (grid.size() == 0 || freqsHz.empty()) {
+            return plans;
+        }
+        for (int elOuter = 0; elOuter < 2; elOuter++) {
+            std::string rows = elOuter ? "rows along AZ" : "rows along EL";
+            std::vector<ScanAngle> raster = orderRaster(grid, elOuter != 0, false);
+            std::vector<ScanAngle> serpentine = orderRaster(grid, elOuter != 0, true);
+
+            plans.push_back(evaluate("raster (" + rows + "), frequency outer", raster, freqsHz, false, startAngle));
+            plans.push_back(evaluate("raster (" + rows + "), frequency inner", raster, freqsHz, true, startAngle));
+            plans.push_back(evaluate("serpentine (" + rows + "), frequency inner", serpentine, freqsHz, true, startAngle));
+            plans.push_back(evaluate("serpentine (" + rows + "), frequency outer", serpentine, freqsHz, false, startAngle));
+        }
+        std::vector<ScanAngle> angles = orderRaster(grid, true, false);
+        plans.push_back(evaluate("tour, frequency inner", orderTour(angles, startAngle), freqsHz, true, startAngle));
+        return plans;
+    }
+
+    // Predicted timing of a given angle order. With frequencyInner every
+    // angle is visited once and all frequencies are measured there (in
+    // alternating direction, so consecutive angles share a frequency);
+    // otherwise the angle order is traversed once per frequency, reversed
+    // on every other pass.
+    ScanPlan evaluate(const std::string &strategy, const std::vector<ScanAngle> &angles,
+                      const std::vector<double> &freqsHz, bool frequencyInner,
+                      const ScanAngle &startAngle = ScanAngle{0.0, 0.0, 0.0}) const
+    {
+        ScanPlan plan;
+        plan.strategy = strategy;
+        plan.steps.reserve(angles.size() * freqsHz.size());
+
+        MotionState state(startAngle);
+        double currentFreq = std::numeric_limits<double>::quiet_NaN();
+        double clock = 0.0;
+
+        auto visit = [&](const ScanAngle &angle, double freqHz) {
+            ScanStep step;
+            step.angle = angle;
+            step.freqHz = freqHz;
+            step.startS = clock;
+            step.approach = false;
+            step.approachAngle = angle;
+            step.move = !state.at(angle);
+            step.moveS = step.move ? moveCost(state, angle, &step.approach, &step.approachAngle) : 0.0;
+            double tune = (currentFreq == currentFreq) ? m_generator.retuneTime(currentFreq, freqHz)
+                                                       : m_generator.settleS;
+            step.tuneS = (step.move && m_generator.tuneDuringMotion)
+                ? std::max(0.0, tune - step.moveS) : tune;
+            step.measureS = m_measureS;
+            currentFreq = freqHz;
+
+            clock += step.moveS + step.tuneS + step.measureS;
+            plan.moveS += step.moveS;
+            plan.tuneS += step.tuneS;
+            plan.measureS += step.measureS;
+            plan.steps.push_back(step);
+        };
+
+        if (frequencyInner) {
+            for (size_t a = 0; a < angles.size(); a++) {
+                for (size_t f = 0; f < freqsHz.size(); f++) {
+                    size_t index = (a % 2 == 0) ? f : freqsHz.size() - 1 - f;
+                    visit(angles[a], freqsHz[index]);
+                }
+            }
+        } else {
+            for (size_t f = 0; f < freqsHz.size(); f++) {
+                for (size_t a = 0; a < angles.size(); a++) {
+                    size_t index = (f % 2 == 0) ? a : angles.size() - 1 - a;
+                    visit(angles[index], freqsHz[f]);
+                }
+            }
+        }
+        plan.durationS = clock;
+        return plan;
+    }
+
+    // Angles of a grid row by row. With elOuter the rows run along AZ.
+    static std::vector<ScanAngle> orderRaster(const ScanGrid &grid, bool elOuter, bool serpentine)
+    {
+        const std::vector<double> &outer = elOuter ? grid.el : grid.az;
+        const std::vector<double> &inner = elOuter ? grid.az : grid.el;
+        std::vector<ScanAngle> angles;
+        angles.reserve(grid.size());
+        for (size_t o = 0; o < outer.size(); o++) {
+            bool reversed = serpentine && (o % 2 == 1);
+            for (size_t i = 0; i < inner.size(); i++) {
+                double value = inner[reversed ? inner.size() - 1 - i : i];
+                ScanAngle angle;
+                angle.az = elOuter ? value : outer[o];
+                angle.el = elOuter ? outer[o] : value;
+                angle.pol = grid.pol;
+                angles.push_back(angle);
+            }
+        }
+        return angles;
+    }
+
+    // Nearest-neighbour tour improved by 2-opt, using the symmetric part
+    // of the motion cost (travel time without backlash handling)
+    std::vector<ScanAngle> orderTour(const std::vector<ScanAngle> &angles,
+                                     const ScanAngle &startAngle) const
+    {
+        size_t n = angles.size();
+        std::vector<ScanAngle> tour;
+        tour.reserve(n);
+        std::vector<bool> used(n, false);
+        ScanAngle current = startAngle;
+        for (size_t k = 0; k < n; k++) {
+            size_t best = n;
+            double bestCost = std::numeric_limits<double>::max();
+            for (size_t i = 0; i < n; i++) {
+                if (used[i]) {
+                    continue;
+                }
+                double cost = travelTime(current, angles[i]);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = i;
+                }
+            }
+            used[best] = true;
+            tour.push_back(angles[best]);
+            current = angles[best];
+        }
+
+        if (n < 4 || n > MaxTwoOptAngles) {
+            return tour;
+        }
+        // Open path from startAngle: reversing tour[i..j] replaces the
+        // edges (i-1, i) and (j, j+1)
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (size_t i = 0; i + 1 < n; i++) {
+                const ScanAngle &before = i == 0 ? startAngle : tour[i - 1];
+                for (size_t j = i + 1; j < n; j++) {
+                    double oldCost = travelTime(before, tour[i]);
+                    double newCost = travelTime(before, tour[j]);
+                    if (j + 1 < n) {
+                        oldCost += travelTime(tour[j], tour[j + 1]);
+                        newCost += travelTime(tour[i], tour[j + 1]);
+                    }
+                    if (newCost < oldCost - 1e-9) {
+                        std::reverse(tour.begin() + static_cast<std::ptrdiff_t>(i),
+                                     tour.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+                        improved = true;
+                    }
+                }
+            }
+        }
+        return tour;
+    }
+
+    // Positioner time between two angles, ignoring backlash
+    double travelTime(const ScanAngle &from, const ScanAngle &to) const
+    {
+        if (from.az == to.az && from.el == to.el && from.pol == to.pol) {
+            return 0.0;
+        }
+        double times[3] = {
+            axisTime(m_positioner.az, to.az - from.az),
+            axisTime(m_positioner.el, to.el - from.el),
+            axisTime(m_positioner.pol, to.pol - from.pol)
+        };
+        return combine(times) + m_positioner.commandOverheadS;
+    }
+
+private:
+    struct MotionState {
+        explicit MotionState(const ScanAngle &start)
+            : position(start)
+        {
+        }
+
+        bool at(const ScanAngle &angle) const
+        {
+            return position.az == angle.az && position.el == angle.el && position.pol == angle.pol;
+        }
+
+        ScanAngle position;
+    };
+
+    static double axisTime(const AxisCostModel &axis, double delta)
+    {
+        if (delta == 0.0) {
+            return 0.0;
+        }
+        return axis.travelTime(delta) + axis.settleS;
+    }
+
+    double combine(const double times[3]) const
+    {
+        if (m_positioner.simultaneousAxes) {
+            return std::max(times[0], std::max(times[1], times[2]));
+        }
+        return times[0] + times[1] + times[2];
+    }
+
+    // Cost of moving to target. An axis with backlash that would arrive
+    // against its approach direction first overshoots by the backlash and
+    // then makes the final approach from the approach side.
+    double moveCost(MotionState &state, const ScanAngle &target, bool *approach,
+                    ScanAngle *approachAngle) const
+    {
+        const AxisCostModel *axes[3] = { &m_positioner.az, &m_positioner.el, &m_positioner.pol };
+        double from[3] = { state.position.az, state.position.el, state.position.pol };
+        double to[3] = { target.az, target.el, target.pol };
+        double via[3] = { to[0], to[1], to[2] };
+        double firstLeg[3] = { 0.0, 0.0, 0.0 };
+        double secondLeg[3] = { 0.0, 0.0, 0.0 };
+        bool needsApproach = false;
+
+        for (int i = 0; i < 3; i++) {
+            double delta = to[i] - from[i];
+            if (delta == 0.0) {
+                continue;
+            }
+            const AxisCostModel &axis = *axes[i];
+            double moveDirection = delta > 0.0 ? 1.0 : -1.0;
+            if (axis.backlashDeg > 0.0 && moveDirection != axis.approachDirection) {
+                via[i] = to[i] - axis.approachDirection * axis.backlashDeg;
+                firstLeg[i] = axisTime(axis, via[i] - from[i]);
+                secondLeg[i] = axisTime(axis, axis.backlashDeg);
+                needsApproach = true;
+            } else {
+                firstLeg[i] = axisTime(axis, delta);
+            }
+        }
+
+        double cost = combine(firstLeg) + m_positioner.commandOverheadS;
+        if (needsApproach) {
+            cost += combine(secondLeg) + m_positioner.commandOverheadS;
+        }
+        *approach = needsApproach;
+        approachAngle->az = via[0];
+        approachAngle->el = via[1];
+        approachAngle->pol = via[2];
+        state.position = target;
+        return cost;
+    }
+
+    PositionerCostModel m_positioner;
+    GeneratorCostModel m_generator;
+    double m_measureS;
+};
+
+#endif // SCANPLANNER_H
@@ -0,0 +1,293 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_KERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Vectorized kernels for trace processing.
+//
+// All kernels work on arrays of doubles, process two elements per SSE2
+// instruction where available and fall back to scalar code otherwise.
+// Unaligned input is fine. The dB conversions use polynomial exp2/log2
+// approximations accurate to ~1e-13 relative (well under 1e-9 dB) for
+// levels between -300 and +300 dB. Outside that range dbToLinear() returns
+// what std::pow returns (including +-inf and NaN); linearToDb() returns
+// what std::log10 returns for +inf and NaN and clamps everything at or
+// below 1e-30 mW (zero and negative input too) to -300 dB. sinCos() is
+// accurate to ~1e-15 for |x| < 1e6 rad.
+
+namespace SimdKernels {
+
+static constexpr double Log2Of10Over10 = 0.33219280948873623;   // log2(10) / 10
+static constexpr double TenLog10Of2 = 3.0102999566398120;       // 10 * log10(2)
+
+#ifdef SIMD_KERNELS_SSE2
+
+// 2^x for any x, matching std::pow: 0 below -1075, inf above 1024 (also
+// for -inf / +inf), NaN for NaN, subnormal results in between
+inline __m128d exp2Pd(__m128d x)
+{
+    // Near the ends of the exponent range the result is built as
+    // 2^(x +- 64) and scaled back at the end, so 2^n stays a normal
+    // number; x is then clamped so n fits the exponent field
+    const __m128d low = _mm_cmplt_pd(x, _mm_set1_pd(-960.0));
+    const __m128d high = _mm_cmpgt_pd(x, _mm_set1_pd(960.0));
+    __m128d shift = _mm_or_pd(_mm_and_pd(low, _mm_set1_pd(64.0)), _mm_and_pd(high, _mm_set1_pd(-64.0)));
+    __m128d rescale = _mm_or_pd(_mm_and_pd(low, _mm_set1_pd(5.421010862427522e-20)),       // 2^-64
+                                _mm_andnot_pd(low, _mm_or_pd(_mm_and_pd(high, _mm_set1_pd(18446744073709551616.0)),
+                                                             _mm_andnot_pd(high, _mm_set1_pd(1.0)))));
+    __m128d isNan = _mm_cmpunord_pd(x, x);
+    __m128d xs = _mm_min_pd(_mm_max_pd(_mm_add_pd(x, shift), _mm_set1_pd(-1022.0)), _mm_set1_pd(1023.0));
+
+    // xs = n + f with n integer and f in [-0.5, 0.5]
+    __m128i n32 = _mm_cvtpd_epi32(xs);                // round to nearest
+    __m128d n = _mm_cvtepi32_pd(n32);
+    __m128d f = _mm_sub_pd(xs, n);
+
+    // 2^f = e^(f ln2), Taylor series to degree 11 (error < 1e-13 on [-0.5, 0.5])
+    const __m128d ln2 = _mm_set1_pd(0.69314718055994531);
+    __m128d t = _mm_mul_pd(f, ln2);
+    __m128d p = _mm_set1_pd(1.0 / 39916800.0);
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 3628800.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 362880.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 40320.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 5040.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 720.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 120.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 24.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0 / 6.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(0.5));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(1.0));
+
+    // 2^n built in the exponent field; sign-extend the two int32 to int64
+    __m128i n64 = _mm_unpacklo_epi32(n32, _mm_srai_epi32(n32, 31));
+    __m128i bits = _mm_slli_epi64(_mm_add_epi64(n64, _mm_set1_epi64x(1023)), 52);
+    __m128d result = _mm_mul_pd(_mm_mul_pd(p, _mm_castsi128_pd(bits)), rescale);
+    return _mm_or_pd(_mm_and_pd(isNan, x), _mm_andnot_pd(isNan, result));
+}
+
+// log2(x) for positive, normal x
+inline __m128d log2Pd(__m128d x)
+{
+    __m128i bits = _mm_castpd_si128(x);
+    // Exponent of each lane as int32 in lanes 0 and 1
+    __m128i exponent64 = _mm_srli_epi64(bits, 52);
+    __m128i exponent32 = _mm_shuffle_epi32(exponent64, _MM_SHUFFLE(3, 3, 2, 0));
+    __m128d e = _mm_cvtepi32_pd(_mm_sub_epi32(exponent32, _mm_set1_epi32(1023)));
+
+    // Mantissa m in [1, 2), folded to [sqrt(1/2), sqrt(2))
+    const __m128i mantissaMask = _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL);
+    const __m128i one = _mm_set1_epi64x(0x3FF0000000000000LL);
+    __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, mantissaMask), one));
+    __m128d large = _mm_cmpgt_pd(m, _mm_set1_pd(1.4142135623730951));
+    m = _mm_or_pd(_mm_and_pd(large, _mm_mul_pd(m, _mm_set1_pd(0.5))), _mm_andnot_pd(large, m));
+    e = _mm_add_pd(e, _mm_and_pd(large, _mm_set1_pd(1.0)));
+
+    // ln(m) = 2 atanh(t), t = (m - 1) / (m + 1), |t| < 0.172
+    __m128d t = _mm_div_pd(_mm_sub_pd(m, _mm_set1_pd(1.0)), _mm_add_pd(m, _mm_set1_pd(1.0)));
+    __m128d t2 = _mm_mul_pd(t, t);
+    __m128d p = _mm_set1_pd(1.0 / 15.0);
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 13.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 11.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 9.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 7.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 5.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0 / 3.0));
+    p = _mm_add_pd(_mm_mul_pd(p, t2), _mm_set1_pd(1.0));
+    __m128d lnM = _mm_mul_pd(_mm_mul_pd(p, t), _mm_set1_pd(2.0));
+    return _mm_add_pd(e, _mm_mul_pd(lnM, _mm_set1_pd(1.4426950408889634)));
+}
+
+// sin(x) and cos(x) for |x| < 1e6; beyond that q pi/2 is no longer
+// subtracted exactly (sin(1e8) is off by ~2e-9)
+inline void sinCosPd(__m128d x, __m128d &sinX, __m128d &cosX)
+{
+    // x = q pi/2 + r with r in [-pi/4, pi/4]; pi/2 split in three parts
+    // (Cody-Waite) so q pi/2 is subtracted without rounding error
+    __m128i q32 = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(0.63661977236758134)));
+    __m128d q = _mm_cvtepi32_pd(q32);
+    __m128d r = _mm_sub_pd(x, _mm_mul_pd(q, _mm_set1_pd(1.5707963267341256)));
+    r = _mm_sub_pd(r, _mm_mul_pd(q, _mm_set1_pd(6.0771005065061922e-11)));
+    r = _mm_sub_pd(r, _mm_mul_pd(q, _mm_set1_pd(2.0222662487959506e-21)));
+
+    // Taylor series to r^15 / r^16 (error < 2e-16 on [-pi/4, pi/4])
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d s = _mm_set1_pd(-1.0 / 1307674368000.0);
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(1.0 / 6227020800.0));
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(-1.0 / 39916800.0));
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(1.0 / 362880.0));
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(-1.0 / 5040.0));
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(1.0 / 120.0));
+    s = _mm_add_pd(_mm_mul_pd(s, r2), _mm_set1_pd(-1.0 / 6.0));
+    s = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(s, r2), r), r);
+    __m128d c = _mm_set1_pd(1.0 / 20922789888000.0);
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(-1.0 / 87178291200.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(1.0 / 479001600.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(-1.0 / 3628800.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(1.0 / 40320.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(-1.0 / 720.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(1.0 / 24.0));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(-0.5));
+    c = _mm_add_pd(_mm_mul_pd(c, r2), _mm_set1_pd(1.0));
+
+    // Quadrant: odd q swaps sin and cos, sin is negated for q = 2, 3 and
+    // cos for q = 1, 2. q is spread to one 64-bit lane per value.
+    __m128i q64 = _mm_shuffle_epi32(q32, _MM_SHUFFLE(1, 1, 0, 0));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    __m128d swap = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(q64, one), one));
+    __m128d sinNegative = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(q64, two), two));
+    __m128d cosNegative = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(q64, one), two), two));
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    __m128d sinAbs = _mm_or_pd(_mm_and_pd(swap, c), _mm_andnot_pd(swap, s));
+    __m128d cosAbs = _mm_or_pd(_mm_and_pd(swap, s), _mm_andnot_pd(swap, c));
+    sinX = _mm_xor_pd(sinAbs, _mm_and_pd(sinNegative, signBit));
+    cosX = _mm_xor_pd(cosAbs, _mm_and_pd(cosNegative, signBit));
+}
+
+#endif // SIMD_KERNELS_SSE2
+
+// out[i] = 10^(in[i] / 10)   (dBm -> mW)
+inline void dbToLinear(const double *in, double *out, size_t count)
+{
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    const __m128d scale = _mm_set1_pd(Log2Of10Over10);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, exp2Pd(_mm_mul_pd(_mm_loadu_pd(in + i), scale)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = std::pow(10.0, in[i] / 10.0);
+    }
+}
+
+// out[i] = 10 log10(in[i])   (mW -> dBm); non-positive input gives -300 dB,
+// +inf and NaN pass through
+inline void linearToDb(const double *in, double *out, size_t count)
+{
+    const double floorLinear = 1e-30;
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    const __m128d scale = _mm_set1_pd(TenLog10Of2);
+    const __m128d floor = _mm_set1_pd(floorLinear);
+    const __m128d infinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(in + i);
+        __m128d x = _mm_max_pd(v, floor);
+        __m128d result = _mm_mul_pd(log2Pd(x), scale);
+        // log2Pd() reads the exponent of inf and NaN as a finite number
+        __m128d special = _mm_or_pd(_mm_cmpunord_pd(v, v), _mm_cmpeq_pd(v, infinity));
+        _mm_storeu_pd(out + i, _mm_or_pd(_mm_and_pd(special, v), _mm_andnot_pd(special, result)));
+    }
+#endif
+    for (; i < count; i++) {
+        double x = in[i] > floorLinear || in[i] != in[i] ? in[i] : floorLinear;
+        out[i] = 10.0 * std::log10(x);
+    }
+}
+
+// Welford running mean / sum of squared deviations; n is the sample count
+// including x (n >= 1)
+inline void welfordUpdate(const double *x, double *mean, double *m2, size_t count, size_t n)
+{
+    const double invN = 1.0 / static_cast<double>(n);
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    const __m128d vInvN = _mm_set1_pd(invN);
+    for (; i + 2 <= count; i += 2) {
+        __m128d vx = _mm_loadu_pd(x + i);
+        __m128d vMean = _mm_loadu_pd(mean + i);
+        __m128d delta = _mm_sub_pd(vx, vMean);
+        vMean = _mm_add_pd(vMean, _mm_mul_pd(delta, vInvN));
+        __m128d vM2 = _mm_add_pd(_mm_loadu_pd(m2 + i), _mm_mul_pd(delta, _mm_sub_pd(vx, vMean)));
+        _mm_storeu_pd(mean + i, vMean);
+        _mm_storeu_pd(m2 + i, vM2);
+    }
+#endif
+    for (; i < count; i++) {
+        double delta = x[i] - mean[i];
+        mean[i] += delta * invN;
+        m2[i] += delta * (x[i] - mean[i]);
+    }
+}
+
+// acc[i] = max(acc[i], x[i])
+inline void maxHold(const double *x, double *acc, size_t count)
+{
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(acc + i, _mm_max_pd(_mm_loadu_pd(acc + i), _mm_loadu_pd(x + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        acc[i] = acc[i] > x[i] ? acc[i] : x[i];
+    }
+}
+
+// sinOut[i] = sin(in[i]), cosOut[i] = cos(in[i])
+inline void sinCos(const double *in, double *sinOut, double *cosOut, size_t count)
+{
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    for (; i + 2 <= count; i += 2) {
+        __m128d s, c;
+        sinCosPd(_mm_loadu_pd(in + i), s, c);
+        _mm_storeu_pd(sinOut + i, s);
+        _mm_storeu_pd(cosOut + i, c);
+    }
+#endif
+    for (; i < count; i++) {
+        sinOut[i] = std::sin(in[i]);
+        cosOut[i] = std::cos(in[i]);
+    }
+}
+
+// out[i] = in[i] + offset[i]
+inline void addArrays(const double *in, const double *offset, double *out, size_t count)
+{
+    size_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(in + i), _mm_loadu_pd(offset + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = in[i] + offset[i];
+    }
+}
+
+} // namespace SimdKernels
+
+#endif // SIMDKERNELS_H
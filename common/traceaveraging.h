@@ -0,0 +1,426 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef TRACEAVERAGING_H
+#define TRACEAVERAGING_H
+
+#include "iplugininterface.h"
+#include "common/simdkernels.h"
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Trace averaging stage for the signal analyzer path.
+//
+// Averaging levels in dB (what repeated findPeak() calls give) biases the
+// result low by up to 2.5 dB on noise and cannot tell when enough sweeps
+// have been taken. TraceAverager averages complete traces per bin with a
+// running mean and variance (Welford), in one of three modes:
+//   - LinearPower: mean of the power in mW, reported in dBm (the correct
+//                  average for noise and modulated signals)
+//   - Log:         mean of the dBm values (video/log averaging, matches
+//                  most analyzers' "log power" average)
+//   - MaxHold:     per-bin maximum
+// The per-bin kernels are vectorized (common/simdkernels.h).
+//
+// averageTraces() reads sweeps until the confidence interval of the
+// averaged level falls below a threshold, and AveragingSignalAnalyzer puts
+// the whole stage behind the ordinary findPeak() call.
+
+enum class TraceAveragingMode {
+    LinearPower,
+    Log,
+    MaxHold
+};
+
+class TraceAverager
+{
+public:
+    explicit TraceAverager(TraceAveragingMode mode = TraceAveragingMode::LinearPower)
+        : m_mode(mode)
+        , m_count(0)
+    {
+    }
+
+    TraceAveragingMode mode() const { return m_mode; }
+    size_t count() const { return m_count; }
+
+    void reset()
+    {
+        m_count = 0;
+        m_mean.clear();
+        m_m2.clear();
+    }
+
+    // Returns false if the trace does not match the frequency axis of the
+    // traces added so far
+    bool add(const Trace &trace)
+    {
+        size_t bins = trace.levelsdBm.size();
+        if (bins == 0) {
+            return false;
+        }
+        if (m_count == 0) {
+            m_startFreqHz = trace.startFreqHz;
+            m_stopFreqHz = trace.stopFreqHz;
+            m_rbwHz = trace.rbwHz;
+            m_firstNs = trace.timestampNs;
+            m_startOffsetSumNs = 0.0;
+            m_sweepTimeSumNs = 0.0;
+            m_timestamped = true;
+            m_mean.assign(bins, 0.0);
+            m_m2.assign(bins, 0.0);
+            m_scratch.resize(bins);
+        } else if (bins != m_mean.size() || trace.startFreqHz != m_startFreqHz ||
+                   trace.stopFreqHz != m_stopFreqHz) {
+            return false;
+        }
+
+        m_count++;
+        m_timestamped = m_timestamped && trace.timestampNs != 0;
+        if (m_timestamped) {
+            m_startOffsetSumNs += static_cast<double>(static_cast<int64_t>(trace.timestampNs - m_firstNs));
+            m_sweepTimeSumNs += static_cast<double>(trace.sweepTimeNs);
+        }
+        const double *levels = trace.levelsdBm.data();
+        switch (m_mode) {
+        case TraceAveragingMode::LinearPower:
+            SimdKernels::dbToLinear(levels, m_scratch.data(), bins);
+            SimdKernels::welfordUpdate(m_scratch.data(), m_mean.data(), m_m2.data(), bins, m_count);
+            break;
+        case TraceAveragingMode::Log:
+            SimdKernels::welfordUpdate(levels, m_mean.data(), m_m2.data(), bins, m_count);
+            break;
+        case TraceAveragingMode::MaxHold:
+            if (m_count == 1) {
+                m_mean.assign(levels, levels + bins);
+            } else {
+                SimdKernels::maxHold(levels, m_mean.data(), bins);
+            }
+            break;
+        }
+        return true;
+    }
+
+    // Averaged trace in dBm. Its timestamps are the mean sweep start and
+    // sweep time, so every point is stamped with its mean measurement time.
+    Trace result() const
+    {
+        Trace trace;
+        trace.startFreqHz = m_startFreqHz;
+        trace.stopFreqHz = m_stopFreqHz;
+        trace.rbwHz = m_rbwHz;
+        if (m_timestamped && m_count > 0) {
+            double n = static_cast<double>(m_count);
+            trace.timestampNs = m_firstNs + static_cast<uint64_t>(m_startOffsetSumNs / n);
+            trace.sweepTimeNs = static_cast<uint64_t>(m_sweepTimeSumNs / n);
+        }
+        trace.levelsdBm.resize(m_mean.size());
+        if (m_mode == TraceAveragingMode::LinearPower) {
+            SimdKernels::linearToDb(m_mean.data(), trace.levelsdBm.data(), m_mean.size());
+        } else {
+            trace.levelsdBm = m_mean;
+        }
+        return trace;
+    }
+
+    // Standard deviation of one sweep at a bin, in the averaging domain
+    // (mW for LinearPower, dB for Log)
+    double stddev(size_t bin) const
+    {
+        if (m_count < 2 || bin >= m_m2.size()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return std::sqrt(m_m2[bin] / static_cast<double>(m_count - 1));
+    }
+
+    // Half-width in dB of the confidence interval of the averaged level at
+    // a bin (z = 1.96 for 95 %). For LinearPower the upper side of the
+    // interval is used, which is the wider one in dB. Not defined for
+    // MaxHold (NaN).
+    double confidenceDb(size_t bin, double z = 1.96) const
+    {
+        if (m_mode == TraceAveragingMode::MaxHold || m_count < 2 || bin >= m_mean.size()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        double halfWidth = z * stddev(bin) / std::sqrt(static_cast<double>(m_count));
+        if (m_mode == TraceAveragingMode::Log) {
+            return halfWidth;
+        }
+        if (m_mean[bin] <= 0.0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return 10.0 * std::log10(1.0 + halfWidth / m_mean[bin]);
+    }
+
+    // Largest confidence half-width over all bins
+    double maxConfidenceDb(double z = 1.96) const
+    {
+        double worst = 0.0;
+        for (size_t i = 0; i < m_mean.size(); i++) {
+            double ci = confidenceDb(i, z);
+            if (!(ci <= worst)) {
+                worst = ci;
+            }
+        }
+        return m_mean.empty() ? std::numeric_limits<double>::quiet_NaN() : worst;
+    }
+
+    // Bin with the highest averaged level
+    size_t peakBin() const
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < m_mean.size(); i++) {
+            if (m_mean[i] > m_mean[best]) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    double binFrequencyHz(size_t bin) const
+    {
+        if (m_mean.size() < 2) {
+            return m_startFreqHz;
+        }
+        return m_startFreqHz + (m_stopFreqHz - m_startFreqHz) * static_cast<double>(bin) /
+                               static_cast<double>(m_mean.size() - 1);
+    }
+
+private:
+    TraceAveragingMode m_mode;
+    size_t m_count;
+    double m_startFreqHz = 0.0;
+    double m_stopFreqHz = 0.0;
+    double m_rbwHz = 0.0;
+    uint64_t m_firstNs = 0;
+    double m_startOffsetSumNs = 0.0;
+    double m_sweepTimeSumNs = 0.0;
+    bool m_timestamped = false;
+    std::vector<double> m_mean;
+    std::vector<double> m_m2;
+    std::vector<double> m_scratch;
+};
+
+struct TraceAveragingSettings {
+    enum Scope {
+        PeakBin,    // stop when the level of the strongest bin is known
+        AllBins     // stop when every bin is known (much slower on noise)
+    };
+
+    TraceAveragingMode mode = TraceAveragingMode::LinearPower;
+    size_t minSweeps = 4;
+    size_t maxSweeps = 100;         // MaxHold always takes maxSweeps
+    double confidenceDb = 0.1;      // target CI half-width
+    double z = 1.96;                // 95 % confidence
+    Scope scope = PeakBin;
+};
+
+struct TraceAveragingResult {
+    bool ok = false;                // at least one sweep was read
+    bool converged = false;         // stopped on the confidence target
+    size_t sweeps = 0;
+    double confidenceDb = std::numeric_limits<double>::quiet_NaN();
+    Trace trace;
+    Peak peak;
+};
+
+// Reads traces until the confidence target or maxSweeps is reached
+inline TraceAveragingResult averageTraces(ISignalAnalyzerPlugin &analyzer,
+                                          const TraceAveragingSettings &settings)
+{
+    TraceAveragingResult result;
+    TraceAverager averager(settings.mode);
+    Trace trace;
+    size_t maxSweeps = settings.maxSweeps > 0 ? settings.maxSweeps : 1;
+    while (averager.count() < maxSweeps) {
+        if (!analyzer.readTrace(trace) || !averager.add(trace)) {
+            break;
+        }
+        if (settings.mode == TraceAveragingMode::MaxHold || averager.count() < settings.minSweeps) {
+            continue;
+        }
+        result.confidenceDb = settings.scope == TraceAveragingSettings::PeakBin
+            ? averager.confidenceDb(averager.peakBin(), settings.z)
+            : averager.maxConfidenceDb(settings.z);
+        if (result.confidenceDb <= settings.confidenceDb) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    result.sweeps = averager.count();
+    result.ok = result.sweeps > 0;
+    if (result.ok) {
+        result.trace = averager.result();
+        size_t bin = averager.peakBin();
+        result.peak.frequencyHz = averager.binFrequencyHz(bin);
+        result.peak.leveldBm = result.trace.levelsdBm[bin];
+        if (result.trace.timestampNs != 0 && result.trace.levelsdBm.size() > 1) {
+            result.peak.timestampNs = result.trace.timestampNs +
+                result.trace.sweepTimeNs * bin / (result.trace.levelsdBm.size() - 1);
+        }
+    }
+    return result;
+}
+
+// Analyzer decorator whose findPeak() returns the peak of an averaged
+// trace. Plugins without readTrace() are averaged over repeated findPeak()
+// calls instead, with the same statistics applied to the peak level.
+// onPeakFound is raised once per averaged peak.
+class AveragingSignalAnalyzer : public ISignalAnalyzerPlugin
+{
+public:
+    AveragingSignalAnalyzer(ISignalAnalyzerPlugin *plugin, const TraceAveragingSettings &settings)
+        : m_plugin(plugin)
+        , m_settings(settings)
+        , m_averaging(false)
+    {
+        m_plugin->onConnected = [this]() { if (onConnected) onConnected(); };
+        m_plugin->onDisconnected = [this]() { if (onDisconnected) onDisconnected(); };
+        m_plugin->onPeakFound = [this](const Peak &peak) {
+            if (!m_averaging && onPeakFound) onPeakFound(peak);
+        };
+        m_plugin->onError = [this](const std::string &error) { if (onError) onError(error); };
+        m_plugin->onDevicesScanned = [this](const std::vector<DeviceInfo> &devices) {
+            if (onDevicesScanned) onDevicesScanned(devices);
+        };
+    }
+
+    ~AveragingSignalAnalyzer() override
+    {
+        m_plugin->onConnected = nullptr;
+        m_plugin->onDisconnected = nullptr;
+        m_plugin->onPeakFound = nullptr;
+        m_plugin->onError = nullptr;
+        m_plugin->onDevicesScanned = nullptr;
+    }
+
+    ISignalAnalyzerPlugin *plugin() const { return m_plugin; }
+
+    // Not synchronized with a running findPeak()
+    void setSettings(const TraceAveragingSettings &settings) { m_settings = settings; }
+    const TraceAveragingSettings &settings() const { return m_settings; }
+
+    // Statistics of the last findPeak()
+    const TraceAveragingResult &lastResult() const { return m_lastResult; }
+
+    std::vector<DeviceInfo> scanDevices() override { return m_plugin->scanDevices(); }
+    bool connectToDevice(const std::string &address) override { return m_plugin->connectToDevice(address); }
+    bool connect() override { return m_plugin->connect(); }
+    void disconnect() override { m_plugin->disconnect(); }
+    bool isConnected() const override { return m_plugin->isConnected(); }
+    void setStartFreq(double freqHz) override { m_plugin->setStartFreq(freqHz); }
+    void setStopFreq(double freqHz) override { m_plugin->setStopFreq(freqHz); }
+    void setRBW(double freqHz) override { m_plugin->setRBW(freqHz); }
+    Peak findPeakFast(double targetAccuracyHz) override { return m_plugin->findPeakFast(targetAccuracyHz); }
+    bool readTrace(Trace &trace) override { return m_plugin->readTrace(trace); }
+    bool captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                         ZeroSpanCapture &capture) override
+    {
+        return m_plugin->captureZeroSpan(centerFreqHz, rbwHz, sampleRateHz, durationS, capture);
+    }
+    uint64_t timestampClockNs() override { return m_plugin->timestampClockNs(); }
+    bool setTriggerIn(TriggerInMode mode, double timeoutS) override { return m_plugin->setTriggerIn(mode, timeoutS); }
+
+    Peak findPeak() override
+    {
+        m_averaging = true;
+        m_lastResult = averageTraces(*m_plugin, m_settings);
+        if (!m_lastResult.ok && m_plugin->isConnected()) {
+            m_lastResult = averagePeaks();
+        }
+        m_averaging = false;
+
+        Peak peak = m_lastResult.peak;
+        if (!m_lastResult.ok) {
+            peak.frequencyHz = 0.0;
+            peak.leveldBm = -100.0;
+            return peak;
+        }
+        if (onPeakFound) {
+            onPeakFound(peak);
+        }
+        return peak;
+    }
+
+private:
+    // Fallback: every findPeak() is a one-bin trace; the frequency is the
+    // plain mean of the reported peak frequencies
+    TraceAveragingResult averagePeaks()
+    {
+        TraceAveragingResult result;
+        TraceAverager averager(m_settings.mode);
+        Trace single;
+        single.startFreqHz = 0.0;
+        single.stopFreqHz = 0.0;
+        single.rbwHz = 0.0;
+        single.levelsdBm.resize(1);
+        double freqSum = 0.0;
+        uint64_t firstNs = 0;
+        double timeOffsetSumNs = 0.0;
+        bool timestamped = true;
+        size_t maxSweeps = m_settings.maxSweeps > 0 ? m_settings.maxSweeps : 1;
+        while (averager.count() < maxSweeps) {
+            Peak peak = m_plugin->findPeak();
+            if (!m_plugin->isConnected()) {
+                break;
+            }
+            single.levelsdBm[0] = peak.leveldBm;
+            averager.add(single);
+            freqSum += peak.frequencyHz;
+            if (averager.count() == 1) {
+                firstNs = peak.timestampNs;
+            }
+            timestamped = timestamped && peak.timestampNs != 0;
+            timeOffsetSumNs += static_cast<double>(static_cast<int64_t>(peak.timestampNs - firstNs));
+            if (m_settings.mode == TraceAveragingMode::MaxHold || averager.count() < m_settings.minSweeps) {
+                continue;
+            }
+            result.confidenceDb = averager.confidenceDb(0, m_settings.z);
+            if (result.confidenceDb <= m_settings.confidenceDb) {
+                result.converged = true;
+                break;
+            }
+        }
+        result.sweeps = averager.count();
+        result.ok = result.sweeps > 0;
+        if (result.ok) {
+            result.trace = averager.result();
+            result.peak.frequencyHz = freqSum / static_cast<double>(result.sweeps);
+            result.peak.leveldBm = result.trace.levelsdBm[0];
+            if (timestamped) {
+                result.peak.timestampNs = firstNs + static_cast<uint64_t>(timeOffsetSumNs / static_cast<double>(result.sweeps));
+            }
+        }
+        return result;
+    }
+
+    ISignalAnalyzerPlugin *m_plugin;
+    TraceAveragingSettings m_settings;
+    TraceAveragingResult m_lastResult;
+    std::atomic<bool> m_averaging;
+};
+
+#endif // TRACEAVERAGING_H
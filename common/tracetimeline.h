@@ -0,0 +1,461 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef TRACETIMELINE_H
+#define TRACETIMELINE_H
+
+#include "iplugininterface.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Timeline recorder for measurement sessions, exported as Chrome
+// trace-event JSON (chrome://tracing, https://ui.perfetto.dev).
+//
+// Every instrument gets its own lane (a "process" in the trace viewer), so
+// the generator, analyzer and positioner timelines are shown one above the
+// other. Events are appended to per-thread buffers; the only lock taken on
+// the recording path is the owning buffer's mutex, which is contended only
+// while writeJson() runs. Recording is off until start() is called and a
+// disabled recorder costs one atomic load per span.
+//
+// Event names and categories are stored as pointers and must outlive the
+// recorder (string literals or method name tables).
+
+// Events are stamped in the plugin timestamp domain (steadyClockNs()), so
+// instrument timestamps can be placed on the timeline directly
+inline uint64_t traceNowNs()
+{
+    return steadyClockNs();
+}
+
+struct TraceEvent {
+    const char *name;
+    const char *category;
+    const char *argName;    // optional single numeric argument
+    double argValue;
+    uint64_t timestampNs;
+    uint64_t durationNs;
+    uint64_t id;            // async events only
+    uint32_t lane;
+    uint32_t thread;
+    char phase;             // 'X' complete, 'i' instant, 'b'/'e' async begin/end
+};
+
+class TraceRecorder
+{
+public:
+    static constexpr size_t ChunkSize = 4096;
+    static constexpr size_t DefaultMaxEventsPerThread = 256 * 1024;
+
+    TraceRecorder()
+        : m_serial(nextSerial())
+        , m_enabled(false)
+        , m_epochNs(traceNowNs())
+        , m_nextAsyncId(1)
+        , m_maxEventsPerThread(DefaultMaxEventsPerThread)
+    {
+    }
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    // Process-wide recorder shared by the instrumented plugin wrappers
+    static TraceRecorder &global()
+    {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    // Discard previous events and start recording
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        for (auto &buffer : m_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->chunks.clear();
+            buffer->count = 0;
+            buffer->dropped = 0;
+        }
+        m_epochNs = traceNowNs();
+        m_enabled.store(true, std::memory_order_release);
+    }
+
+    void stop()
+    {
+        m_enabled.store(false, std::memory_order_release);
+    }
+
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Events beyond this limit are counted as dropped instead of recorded
+    void setMaxEventsPerThread(size_t maxEvents)
+    {
+        m_maxEventsPerThread.store(maxEvents, std::memory_order_relaxed);
+    }
+
+    // Lane (trace "process") for an instrument; the same name returns the
+    // same lane
+    uint32_t lane(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        for (size_t i = 0; i < m_laneNames.size(); i++) {
+            if (m_laneNames[i] == name) {
+                return static_cast<uint32_t>(i + 1);
+            }
+        }
+        m_laneNames.push_back(name);
+        return static_cast<uint32_t>(m_laneNames.size());
+    }
+
+    // Name shown for the calling thread
+    void setThreadName(const std::string &name)
+    {
+        ThreadBuffer *buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->name = name;
+    }
+
+    uint64_t nextAsyncId()
+    {
+        return m_nextAsyncId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Span that started at startNs and ended at endNs on the calling thread
+    void complete(uint32_t lane, const char *name, const char *category,
+                  uint64_t startNs, uint64_t endNs,
+                  const char *argName = nullptr, double argValue = 0.0)
+    {
+        if (!isEnabled()) {
+            return;
+        }
+        TraceEvent event = makeEvent(lane, name, category, 'X', startNs);
+        event.durationNs = endNs > startNs ? endNs - startNs : 0;
+        event.argName = argName;
+        event.argValue = argValue;
+        append(event);
+    }
+
+    void instant(uint32_t lane, const char *name, const char *category,
+                 const char *argName = nullptr, double argValue = 0.0)
+    {
+        if (!isEnabled()) {
+            return;
+        }
+        TraceEvent event = makeEvent(lane, name, category, 'i', traceNowNs());
+        event.argName = argName;
+        event.argValue = argValue;
+        append(event);
+    }
+
+    // Span that may start and end on different threads or overlap other
+    // spans of the same thread (e.g. positioner motion). Shown as a
+    // separate track of the lane.
+    void async(uint32_t lane, const char *name, const char *category,
+               uint64_t startNs, uint64_t endNs)
+    {
+        if (!isEnabled()) {
+            return;
+        }
+        uint64_t id = nextAsyncId();
+        TraceEvent begin = makeEvent(lane, name, category, 'b', startNs);
+        begin.id = id;
+        TraceEvent end = makeEvent(lane, name, category, 'e', endNs);
+        end.id = id;
+        append(begin);
+        append(end);
+    }
+
+    size_t eventCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        size_t total = 0;
+        for (const auto &buffer : m_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            total += buffer->count;
+        }
+        return total;
+    }
+
+    uint64_t droppedEvents() const
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        uint64_t total = 0;
+        for (const auto &buffer : m_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            total += buffer->dropped;
+        }
+        return total;
+    }
+
+    // Chrome trace-event JSON ("JSON object format")
+    void writeJson(std::ostream &out) const
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&out, &first]() {
+            if (!first) {
+                out << ",\n";
+            }
+            first = false;
+        };
+
+        for (size_t i = 0; i < m_laneNames.size(); i++) {
+            separator();
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << (i + 1)
+                << ",\"tid\":0,\"args\":{\"name\":\"" << escape(m_laneNames[i]) << "\"}}";
+            separator();
+            out << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << (i + 1)
+                << ",\"tid\":0,\"args\":{\"sort_index\":" << i << "}}";
+        }
+
+        char number[64];
+        for (const auto &buffer : m_buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            std::vector<uint32_t> lanesSeen;
+            for (size_t c = 0; c < buffer->chunks.size(); c++) {
+                size_t used = (c + 1 < buffer->chunks.size()) ? ChunkSize
+                                                              : buffer->count - c * ChunkSize;
+                for (size_t e = 0; e < used; e++) {
+                    const TraceEvent &event = buffer->chunks[c][e];
+                    bool seen = false;
+                    for (uint32_t lane : lanesSeen) {
+                        if (lane == event.lane) {
+                            seen = true;
+                            break;
+                        }
+                    }
+                    if (!seen) {
+                        lanesSeen.push_back(event.lane);
+                    }
+
+                    separator();
+                    out << "{\"name\":\"" << escape(event.name) << "\",\"cat\":\""
+                        << escape(event.category) << "\",\"ph\":\"" << event.phase
+                        << "\",\"pid\":" << event.lane << ",\"tid\":" << event.thread;
+                    std::snprintf(number, sizeof(number), "%.3f", relativeUs(event.timestampNs));
+                    out << ",\"ts\":" << number;
+                    if (event.phase == 'X') {
+                        std::snprintf(number, sizeof(number), "%.3f", event.durationNs / 1000.0);
+                        out << ",\"dur\":" << number;
+                    } else if (event.phase == 'i') {
+                        out << ",\"s\":\"t\"";
+                    } else {
+                        out << ",\"id\":\"0x" << std::hex << event.id << std::dec << "\"";
+                    }
+                    if (event.argName != nullptr) {
+                        std::snprintf(number, sizeof(number), "%.17g", event.argValue);
+                        out << ",\"args\":{\"" << escape(event.argName) << "\":" << number << "}";
+                    }
+                    out << "}";
+                }
+            }
+
+            std::string threadName = buffer->name.empty()
+                ? "thread " + std::to_string(buffer->thread) : buffer->name;
+            for (uint32_t lane : lanesSeen) {
+                separator();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << lane
+                    << ",\"tid\":" << buffer->thread << ",\"args\":{\"name\":\""
+                    << escape(threadName) << "\"}}";
+            }
+        }
+        out << "]}" << std::endl;
+    }
+
+    bool writeFile(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeJson(file);
+        return file.good();
+    }
+
+private:
+    struct ThreadBuffer {
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+        size_t count = 0;
+        uint64_t dropped = 0;
+        uint32_t thread = 0;
+        std::thread::id owner;
+        std::string name;
+    };
+
+    static uint64_t nextSerial()
+    {
+        static std::atomic<uint64_t> serial{1};
+        return serial.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::string escape(const std::string &text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    double relativeUs(uint64_t timestampNs) const
+    {
+        // Events recorded just before start() may predate the epoch
+        if (timestampNs >= m_epochNs) {
+            return (timestampNs - m_epochNs) / 1000.0;
+        }
+        return -static_cast<double>(m_epochNs - timestampNs) / 1000.0;
+    }
+
+    TraceEvent makeEvent(uint32_t lane, const char *name, const char *category,
+                         char phase, uint64_t timestampNs)
+    {
+        TraceEvent event;
+        event.name = name;
+        event.category = category;
+        event.argName = nullptr;
+        event.argValue = 0.0;
+        event.timestampNs = timestampNs;
+        event.durationNs = 0;
+        event.id = 0;
+        event.lane = lane;
+        event.thread = 0;
+        event.phase = phase;
+        return event;
+    }
+
+    void append(TraceEvent &event)
+    {
+        ThreadBuffer *buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->count >= m_maxEventsPerThread.load(std::memory_order_relaxed)) {
+            buffer->dropped++;
+            return;
+        }
+        size_t offset = buffer->count % ChunkSize;
+        if (offset == 0 && buffer->count / ChunkSize == buffer->chunks.size()) {
+            buffer->chunks.emplace_back(new TraceEvent[ChunkSize]);
+        }
+        event.thread = buffer->thread;
+        buffer->chunks.back()[offset] = event;
+        buffer->count++;
+    }
+
+    // Buffer of the calling thread, created on first use. The last lookup
+    // is cached per thread so the common case does not touch the registry.
+    ThreadBuffer *threadBuffer()
+    {
+        struct Cache {
+            uint64_t serial = 0;
+            ThreadBuffer *buffer = nullptr;
+        };
+        static thread_local Cache cache;
+        if (cache.serial == m_serial) {
+            return cache.buffer;
+        }
+
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        std::thread::id self = std::this_thread::get_id();
+        ThreadBuffer *found = nullptr;
+        for (auto &buffer : m_buffers) {
+            if (buffer->owner == self) {
+                found = buffer.get();
+                break;
+            }
+        }
+        if (found == nullptr) {
+            m_buffers.emplace_back(new ThreadBuffer());
+            found = m_buffers.back().get();
+            found->owner = self;
+            found->thread = static_cast<uint32_t>(m_buffers.size());
+        }
+        cache.serial = m_serial;
+        cache.buffer = found;
+        return found;
+    }
+
+    const uint64_t m_serial;
+    std::atomic<bool> m_enabled;
+    uint64_t m_epochNs;
+    std::atomic<uint64_t> m_nextAsyncId;
+    std::atomic<size_t> m_maxEventsPerThread;
+
+    mutable std::mutex m_registryMutex;
+    std::vector<std::string> m_laneNames;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
+
+// RAII span on the calling thread
+class TraceSpan
+{
+public:
+    TraceSpan(TraceRecorder *recorder, uint32_t lane, const char *name, const char *category)
+        : m_recorder(recorder && recorder->isEnabled() ? recorder : nullptr)
+        , m_lane(lane)
+        , m_name(name)
+        , m_category(category)
+        , m_startNs(m_recorder ? traceNowNs() : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_recorder) {
+            m_recorder->complete(m_lane, m_name, m_category, m_startNs, traceNowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    TraceRecorder *m_recorder;
+    uint32_t m_lane;
+    const char *m_name;
+    const char *m_category;
+    uint64_t m_startNs;
+};
+
+#endif // TRACETIMELINE_H
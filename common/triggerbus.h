@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef TRIGGERBUS_H
+#define TRIGGERBUS_H
+
+#include "iplugininterface.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Simulated trigger wiring between instruments.
+//
+// A TriggerLine stands for one BNC cable: outputs fire() edges onto it,
+// inputs wait for them or listen. Edges are numbered from 1 and stamped
+// with steadyClockNs(), and the last HistorySize edges are kept. An
+// instrument can therefore pick up an edge it was armed for even when the
+// host thread that waits for it is late, as a hardware trigger latch
+// would. Listeners run synchronously on the firing thread, like a wired
+// input, and must not block.
+//
+// The dummy plugins are wired up through their exported attach functions
+// (see PLUGIN_DEVELOPMENT.md); TriggerBus only owns named lines.
+
+struct TriggerEdge {
+    uint64_t sequence;
+    uint64_t timestampNs;
+
+    TriggerEdge() : sequence(0), timestampNs(0) {}
+};
+
+class TriggerLine
+{
+public:
+    typedef std::function<void(const TriggerEdge&)> Listener;
+    static constexpr size_t HistorySize = 4096;
+
+    explicit TriggerLine(const std::string &name = std::string())
+        : m_name(name)
+        , m_edgeCount(0)
+        , m_nextListenerId(1)
+    {
+    }
+
+    TriggerLine(const TriggerLine &) = delete;
+    TriggerLine &operator=(const TriggerLine &) = delete;
+
+    const std::string &name() const { return m_name; }
+
+    // Raises an edge now and returns its sequence number
+    uint64_t fire()
+    {
+        TriggerEdge edge;
+        std::vector<std::shared_ptr<Listener>> listeners;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            edge.sequence = ++m_edgeCount;
+            edge.timestampNs = steadyClockNs();
+            m_history.push_back(edge);
+            if (m_history.size() > HistorySize) {
+                m_history.pop_front();
+            }
+            for (auto &entry : m_listeners) {
+                listeners.push_back(entry.second);
+            }
+        }
+        m_edgeArrived.notify_all();
+        for (auto &listener : listeners) {
+            (*listener)(edge);
+        }
+        return edge.sequence;
+    }
+
+    uint64_t edgeCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_edgeCount;
+    }
+
+    // Waits for edge afterSequence + 1. Returns false on timeout, or if
+    // that edge has already dropped out of the history.
+    bool waitForEdge(uint64_t afterSequence, double timeoutS, TriggerEdge &edge)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(timeoutS > 0.0 ? timeoutS : 0.0));
+        if (!m_edgeArrived.wait_for(lock, timeout, [&]() { return m_edgeCount > afterSequence; })) {
+            return false;
+        }
+        uint64_t wanted = afterSequence + 1;
+        uint64_t oldest = m_edgeCount - m_history.size() + 1;
+        if (wanted < oldest) {
+            return false;
+        }
+        edge = m_history[static_cast<size_t>(wanted - oldest)];
+        return true;
+    }
+
+    // Listeners may still be running for an edge fired while they are
+    // removed; remove them before destroying what they capture.
+    int addListener(const Listener &listener)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int id = m_nextListenerId++;
+        m_listeners[id] = std::make_shared<Listener>(listener);
+        return id;
+    }
+
+    void removeListener(int id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listeners.erase(id);
+    }
+
+private:
+    std::string m_name;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_edgeArrived;
+    std::deque<TriggerEdge> m_history;
+    uint64_t m_edgeCount;
+    std::map<int, std::shared_ptr<Listener>> m_listeners;
+    int m_nextListenerId;
+};
+
+// Named trigger lines, created on first use. References stay valid for
+// the lifetime of the bus.
+class TriggerBus
+{
+public:
+    TriggerLine &line(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<TriggerLine> &line = m_lines[name];
+        if (!line) {
+            line.reset(new TriggerLine(name));
+        }
+        return *line;
+    }
+
+    std::vector<std::string> lineNames() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::string> names;
+        for (const auto &entry : m_lines) {
+            names.push_back(entry.first);
+        }
+        return names;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<TriggerLine>> m_lines;
+};
+
+#endif // TRIGGERBUS_H
@@ -0,0 +1,264 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef VIRTUALRANGE_H
+#define VIRTUALRANGE_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+
+// Radiation pattern of the antenna under test, relative to its mount.
+// Angles in degrees.
+struct AntennaPattern {
+    double peakGaindBi;
+    double azBeamwidthDeg;          // -3 dB beamwidth
+    double elBeamwidthDeg;
+    double boresightAZ;
+    double boresightEL;
+    double polarizationDeg;         // POL angle of co-polar alignment
+    double sidelobeLeveldB;         // first sidelobe, relative to the peak
+    double backlobeLeveldB;         // floor of the sidelobe envelope
+    double crossPolDiscriminationdB;
+
+    AntennaPattern()
+        : peakGaindBi(15.0)
+        , azBeamwidthDeg(20.0)
+        , elBeamwidthDeg(20.0)
+        , boresightAZ(0.0)
+        , boresightEL(0.0)
+        , polarizationDeg(0.0)
+        , sidelobeLeveldB(-20.0)
+        , backlobeLeveldB(-40.0)
+        , crossPolDiscriminationdB(30.0)
+    {}
+
+    // Gain towards the range antenna with the positioner at az/el/pol.
+    // Gaussian main lobe (-3 dB at half the beamwidth) down to a sidelobe
+    // envelope falling 20 dB per decade of beamwidths.
+    double gaindBi(double az, double el, double pol) const
+    {
+        double dAz = std::remainder(az - boresightAZ, 360.0) / std::max(azBeamwidthDeg, 1e-3);
+        double dEl = std::remainder(el - boresightEL, 360.0) / std::max(elBeamwidthDeg, 1e-3);
+        double u = std::sqrt(dAz * dAz + dEl * dEl);
+        double mainLobe = -12.0 * u * u;
+        double sidelobes = std::max(sidelobeLeveldB - 20.0 * std::log10(std::max(u, 1.0)), backlobeLeveldB);
+        double pattern = std::max(mainLobe, sidelobes);
+        return peakGaindBi + pattern + polarizationLossdB(pol - polarizationDeg, crossPolDiscriminationdB);
+    }
+
+    // Gain change of a linearly polarized antenna rotated by mismatchDeg
+    // from co-polar alignment
+    static double polarizationLossdB(double mismatchDeg, double crossPolDiscriminationdB)
+    {
+        const double pi = 3.14159265358979323846;
+        double mismatch = mismatchDeg * pi / 180.0;
+        double coPol = std::cos(mismatch) * std::cos(mismatch);
+        double crossPol = std::sin(mismatch) * std::sin(mismatch) * std::pow(10.0, -crossPolDiscriminationdB / 10.0);
+        return 10.0 * std::log10(coPol + crossPol);
+    }
+};
+
+// Shared state of a simulated antenna range: the generator feeds the range
+// antenna, the positioner turns the antenna under test, and the analyzer
+// receives
+//   power + range antenna gain + AUT gain(az, el, pol) - FSPL(d, f) - losses
+// over a thermal noise floor, optionally through the amplifier of an
+// active antenna. The dummy plugins publish their state here
+// once attached (attachDummy*VirtualRange, see PLUGIN_DEVELOPMENT.md).
+// All methods are thread-safe.
+class VirtualRange
+{
+public:
+    typedef std::function<double(double az, double el, double pol)> PatternFunction;
+
+    VirtualRange()
+        : m_rangeAntennaGaindBi(10.0)
+        , m_lossdB(3.0)
+        , m_noiseDensitydBmHz(-160.0)
+        , m_distanceM(10.0)
+        , m_sourceOn(false)
+        , m_sourceFreqHz(0.0)
+        , m_sourcePowerdBm(0.0)
+        , m_az(0.0)
+        , m_el(0.0)
+        , m_pol(0.0)
+        , m_amplifier(false)
+        , m_amplifierGaindB(0.0)
+        , m_amplifierSaturationdBm(0.0)
+        , m_amplifierSmoothness(2.0)
+    {
+    }
+
+    VirtualRange(const VirtualRange &) = delete;
+    VirtualRange &operator=(const VirtualRange &) = delete;
+
+    // Range configuration
+    void setAntennaPattern(const AntennaPattern &pattern)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pattern = pattern;
+        m_patternFunction = nullptr;
+    }
+
+    // Measured or synthetic pattern in dBi, replaces the model
+    void setPatternFunction(const PatternFunction &pattern)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_patternFunction = pattern;
+    }
+
+    void setRangeAntennaGain(double gaindBi)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rangeAntennaGaindBi = gaindBi;
+    }
+
+    // Cable and mismatch loss of both paths
+    void setLoss(double lossdB)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lossdB = lossdB;
+    }
+
+    // Amplifier behind the AUT with the Rapp AM/AM characteristic:
+    // small-signal gain, output 1 dB compression point and smoothness p
+    // (larger is a sharper knee)
+    void setAmplifier(double gaindB, double outputP1dBdBm, double smoothness = 2.0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        double p = std::max(smoothness, 0.1);
+        // Input amplitude at P1dB relative to saturation
+        double x = std::pow(std::pow(10.0, p / 10.0) - 1.0, 1.0 / (2.0 * p));
+        m_amplifier = true;
+        m_amplifierGaindB = gaindB;
+        m_amplifierSaturationdBm = outputP1dBdBm + 1.0 - 20.0 * std::log10(x);
+        m_amplifierSmoothness = p;
+    }
+
+    void clearAmplifier()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_amplifier = false;
+    }
+
+    void setNoiseDensity(double dBmPerHz)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_noiseDensitydBmHz = dBmPerHz;
+    }
+
+    // Published by the instruments
+    void setSource(bool rfOn, double freqHz, double powerdBm)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sourceOn = rfOn;
+        m_sourceFreqHz = freqHz;
+        m_sourcePowerdBm = powerdBm;
+    }
+
+    void setPosition(double az, double el, double pol)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_az = az;
+        m_el = el;
+        m_pol = pol;
+    }
+
+    // Range length in meters; ignored unless positive
+    void setDistance(double distanceM)
+    {
+        if (distanceM > 0.0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_distanceM = distanceM;
+        }
+    }
+
+    // Tone at the analyzer input; false while the source is off
+    bool receivedTone(double &freqHz, double &leveldBm) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_sourceOn || m_sourceFreqHz <= 0.0) {
+            return false;
+        }
+        freqHz = m_sourceFreqHz;
+        leveldBm = levelAt(m_az, m_el, m_pol);
+        return true;
+    }
+
+    // Level the analyzer would read at the given angles with the current
+    // source, i.e. the ground truth a scan is checked against
+    double expectedLeveldBm(double az, double el, double pol) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return levelAt(az, el, pol);
+    }
+
+    double noiseDensitydBmHz() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_noiseDensitydBmHz;
+    }
+
+    static double freeSpaceLossdB(double distanceM, double freqHz)
+    {
+        const double pi = 3.14159265358979323846;
+        const double c = 299792458.0;
+        return 20.0 * std::log10(std::max(4.0 * pi * distanceM * freqHz / c, 1.0));
+    }
+
+private:
+    double levelAt(double az, double el, double pol) const
+    {
+        double autGaindBi = m_patternFunction ? m_patternFunction(az, el, pol) : m_pattern.gaindBi(az, el, pol);
+        double leveldBm = m_sourcePowerdBm + m_rangeAntennaGaindBi + autGaindBi
+                          - freeSpaceLossdB(m_distanceM, m_sourceFreqHz) - m_lossdB;
+        if (!m_amplifier) {
+            return leveldBm;
+        }
+        double linear = leveldBm + m_amplifierGaindB;
+        double ratio = std::pow(10.0, (linear - m_amplifierSaturationdBm) * m_amplifierSmoothness / 10.0);
+        return linear - 10.0 / m_amplifierSmoothness * std::log10(1.0 + ratio);
+    }
+
+    mutable std::mutex m_mutex;
+    AntennaPattern m_pattern;
+    PatternFunction m_patternFunction;
+    double m_rangeAntennaGaindBi;
+    double m_lossdB;
+    double m_noiseDensitydBmHz;
+    double m_distanceM;
+    bool m_sourceOn;
+    double m_sourceFreqHz;
+    double m_sourcePowerdBm;
+    double m_az;
+    double m_el;
+    double m_pol;
+    bool m_amplifier;
+    double m_amplifierGaindB;
+    double m_amplifierSaturationdBm;
+    double m_amplifierSmoothness;
+};
+
+#endif // VIRTUALRANGE_H
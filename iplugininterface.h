@@ -27,6 +27,17 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <chrono>
+#include <cstdint>
+
+// Timestamps (timestampNs) are nanoseconds of the host steady clock, taken
+// at the instrument event; 0 means not stamped. Plugins whose instrument
+// has its own clock convert to this domain (see common/clocksync.h).
+inline uint64_t steadyClockNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
 
 // Device information structure
 struct DeviceInfo {
@@ -39,10 +50,73 @@ struct DeviceInfo {
     DeviceInfo() : isAvailable(true) {}
 };
 
-// Peak data structure for Signal Analyzer
+// Peak data structure for Signal Analyzer (timestampNs is new in interface
+// 2.0; the size of Peak is part of the plugin ABI)
 struct Peak {
     double frequencyHz;
     double leveldBm;
+    uint64_t timestampNs;       // When the peak bin was measured
+    
+    Peak() : frequencyHz(0.0), leveldBm(0.0), timestampNs(0) {}
+};
+
+// Trace data structure for Signal Analyzer: one sweep, levels at equally
+// spaced frequencies from startFreqHz to stopFreqHz (inclusive). A swept
+// analyzer measures the points evenly over sweepTimeNs from timestampNs.
+struct Trace {
+    double startFreqHz;
+    double stopFreqHz;
+    double rbwHz;
+    std::vector<double> levelsdBm;
+    uint64_t timestampNs;       // Start of the sweep
+    uint64_t sweepTimeNs;
+    
+    Trace() : startFreqHz(0.0), stopFreqHz(0.0), rbwHz(0.0), timestampNs(0), sweepTimeNs(0) {}
+};
+
+// Detected power versus time at one frequency (zero span)
+struct ZeroSpanCapture {
+    double centerFreqHz;
+    double rbwHz;
+    double sampleRateHz;
+    std::vector<double> levelsdBm;
+    uint64_t timestampNs;       // First sample
+    
+    ZeroSpanCapture() : centerFreqHz(0.0), rbwHz(0.0), sampleRateHz(0.0), timestampNs(0) {}
+    
+    uint64_t sampleTimeNs(size_t index) const
+    {
+        return sampleRateHz > 0.0 ? timestampNs + (uint64_t)((double)index * 1e9 / sampleRateHz) : timestampNs;
+    }
+};
+
+// Output channel capabilities for Signal Generator. Channel 0 is the
+// primary output driven by setFreq()/setPower()/enableRf().
+struct ChannelInfo {
+    std::string name;
+    double minFreqHz;
+    double maxFreqHz;
+    double freqResolutionHz;    // Tuning step (frequencies are rounded to it)
+    bool hasPowerControl;
+    bool hasOutputControl;      // Output can be switched on/off
+    
+    ChannelInfo() : minFreqHz(0.0), maxFreqHz(0.0), freqResolutionHz(0.0),
+                    hasPowerControl(true), hasOutputControl(true) {}
+};
+
+// Hardware trigger routing (optional). A trigger output pulses an external
+// line; a trigger input makes the instrument act on an edge of one instead
+// of on a software command over the bus.
+enum class TriggerOutMode {
+    Off,
+    EveryStep,          // each list step once settled / each compare position
+    CycleComplete       // end of each list cycle
+};
+
+enum class TriggerInMode {
+    Software,           // no external trigger
+    StartSweep,         // an edge starts the list sweep or measurement
+    EveryStep           // every edge advances the list by one step
 };
 
 // Positioner data structures
@@ -82,6 +156,33 @@ struct Movement {
     double V;
 };
 
+// Encoder position at timestampNs
+struct PositionSample {
+    double AZ;
+    double EL;
+    double POL;
+    uint64_t timestampNs;
+    
+    PositionSample() : AZ(0.0), EL(0.0), POL(0.0), timestampNs(0) {}
+    PositionSample(double az, double el, double pol, uint64_t timestamp)
+        : AZ(az), EL(el), POL(pol), timestampNs(timestamp) {}
+};
+
+// Point of a queued positioner path. With blend set the positioner passes
+// through the waypoint towards the next one without stopping; otherwise
+// it settles there first. id is reported back by onWaypointReached.
+struct Waypoint {
+    double AZ;
+    double EL;
+    double POL;
+    bool blend;
+    int id;
+    
+    Waypoint() : AZ(0.0), EL(0.0), POL(0.0), blend(false), id(0) {}
+    Waypoint(double az, double el, double pol, bool blendThrough, int waypointId)
+        : AZ(az), EL(el), POL(pol), blend(blendThrough), id(waypointId) {}
+};
+
 // Plugin interface for Signal Analyzer
 class ISignalAnalyzerPlugin
 {
@@ -105,6 +206,40 @@ public:
     // Measurement
     virtual Peak findPeak() = 0;
     
+    // Coarse-to-fine peak search: locate the peak with a wide, coarse-RBW
+    // sweep and zoom in until the frequency is known to about
+    // targetAccuracyHz. The configured span and RBW are restored afterwards.
+    // Plugins without a faster strategy fall back to findPeak().
+    virtual Peak findPeakFast(double targetAccuracyHz) { (void)targetAccuracyHz; return findPeak(); }
+    
+    // Full sweep of the configured span. Returns false if the plugin does
+    // not provide traces or the sweep failed.
+    virtual bool readTrace(Trace &trace) { (void)trace; return false; }
+    
+    // Zero-span capture: durationS of detected power at centerFreqHz,
+    // sampled at sampleRateHz into capture, whose buffer is reused. Starts
+    // on the trigger input like a sweep and leaves the swept span and RBW
+    // settings unchanged. Returns false if the plugin cannot capture.
+    virtual bool captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                                 ZeroSpanCapture &capture)
+    {
+        (void)centerFreqHz; (void)rbwHz; (void)sampleRateHz; (void)durationS; (void)capture;
+        return false;
+    }
+    
+    // Current reading of the clock behind timestampNs, in its own domain.
+    // Lets the host estimate offset and latency (common/clocksync.h).
+    virtual uint64_t timestampClockNs() { return steadyClockNs(); }
+    
+    // External trigger input. With StartSweep every findPeak()/readTrace()
+    // sweeps on the next trigger edge and fails after timeoutS without one.
+    // Returns false for modes the analyzer does not support.
+    virtual bool setTriggerIn(TriggerInMode mode, double timeoutS)
+    {
+        (void)timeoutS;
+        return mode == TriggerInMode::Software;
+    }
+    
     // Callback functions for events (optional, can be nullptr)
     std::function<void()> onConnected;
     std::function<void()> onDisconnected;
@@ -131,12 +266,74 @@ public:
     // Configuration
     virtual void setFreq(double freqHz) = 0;
     virtual void setPower(double powerDbm) = 0;
+    // Level last set with setPower(); false if the plugin does not track it
+    virtual bool getPower(double &powerDbm) const { (void)powerDbm; return false; }
     
     // RF Control
     virtual void enableRf() = 0;
     virtual void disableRf() = 0;
     virtual bool isRfEnabled() const = 0;
     
+    // Settled mode: setFreq() returns only once the synthesizer reports
+    // lock (or timeoutMs expires) and raises onFreqSettled with the
+    // measured lock time. Returns false if the plugin cannot detect lock.
+    virtual bool setSettledMode(bool enabled, double timeoutMs) { (void)enabled; (void)timeoutMs; return false; }
+    
+    // Multi-channel generators. The defaults describe a single-channel
+    // device and map channel 0 onto the calls above; channelInfo() returns
+    // false when the plugin does not describe its channels. The channel
+    // setters return false for channels or controls that do not exist.
+    virtual int channelCount() const { return 1; }
+    virtual bool channelInfo(int channel, ChannelInfo &info) const { (void)channel; (void)info; return false; }
+    virtual bool setChannelFreq(int channel, double freqHz)
+    {
+        if (channel != 0) return false;
+        setFreq(freqHz);
+        return true;
+    }
+    virtual bool setChannelPower(int channel, double powerDbm)
+    {
+        if (channel != 0) return false;
+        setPower(powerDbm);
+        return true;
+    }
+    virtual bool setChannelRfEnabled(int channel, bool enabled)
+    {
+        if (channel != 0) return false;
+        if (enabled) enableRf(); else disableRf();
+        return isRfEnabled() == enabled;
+    }
+    virtual bool isChannelRfEnabled(int channel) const { return channel == 0 && isRfEnabled(); }
+    
+    // Fast frequency hopping on channel 0: loadHopTable() precomputes the
+    // device settings for each frequency, hopTo() then tunes to table entry
+    // index with minimal per-call overhead. With verification enabled every
+    // hop is read back from the device. Plugins without a fast path return
+    // false from loadHopTable() and hosts fall back to setFreq().
+    virtual bool loadHopTable(const std::vector<double> &freqsHz) { (void)freqsHz; return false; }
+    virtual bool hopTo(size_t index) { (void)index; return false; }
+    virtual bool setHopVerification(bool enabled) { (void)enabled; return false; }
+    
+    // Hardware list sweeps on channel 0: loadFreqList() places the list in
+    // device memory, startFreqList() steps through it every dwellS for
+    // the given number of cycles (0 = until stopFreqList()). Plugins
+    // without list mode return false.
+    virtual bool loadFreqList(const std::vector<double> &freqsHz) { (void)freqsHz; return false; }
+    virtual bool startFreqList(double dwellS, unsigned int cycles) { (void)dwellS; (void)cycles; return false; }
+    virtual bool stopFreqList() { return false; }
+    
+    // Trigger routing for list sweeps, applied by the next startFreqList().
+    // The trigger input replaces the software start (StartSweep) or the
+    // dwell timer (EveryStep). Returns false for unsupported modes.
+    virtual bool setTriggerOut(TriggerOutMode mode) { return mode == TriggerOutMode::Off; }
+    virtual bool setTriggerIn(TriggerInMode mode) { return mode == TriggerInMode::Software; }
+    
+    // Power management: the host announces that the generator will not be
+    // used for idleS seconds (e.g. while the positioner moves). The plugin
+    // may power down and must be ready again when the gap ends; calls made
+    // earlier wake it immediately. Returns false without power management.
+    virtual bool announceIdle(double idleS) { (void)idleS; return false; }
+    
     // Callback functions for events (optional, can be nullptr)
     std::function<void()> onConnected;
     std::function<void()> onDisconnected;
@@ -144,6 +341,7 @@ public:
     std::function<void()> onRfDisabled;
     std::function<void(const std::string&)> onError;
     std::function<void(const std::vector<DeviceInfo>&)> onDevicesScanned;
+    std::function<void(double freqHz, double lockTimeUs)> onFreqSettled;
 };
 
 // Plugin interface for Positioner
@@ -180,12 +378,35 @@ public:
     virtual void moveTo(double azimuth, double elevation) = 0;
     virtual void moveTo(double azimuth, double elevation, double polar) = 0;
     
+    // Path streaming (optional). Appends waypoints behind the ones already
+    // queued; moveTo(), start() and stop() discard the pending path.
+    // Returns false if the positioner cannot queue motion.
+    virtual bool queueWaypoints(const std::vector<Waypoint> &waypoints) { (void)waypoints; return false; }
+    
+    // Current reading of the clock behind PositionSample::timestampNs
+    virtual uint64_t timestampClockNs() { return steadyClockNs(); }
+    
+    // Position-compare trigger output: pulses as axis (0 AZ, 1 EL, 2 POL)
+    // passes startDeg + k * intervalDeg, k = 0 .. count - 1, each point once
+    // and in order (a negative interval compares downwards). count 0
+    // disables it.
+    virtual bool setPositionCompare(int axis, double startDeg, double intervalDeg, unsigned int count)
+    {
+        (void)axis; (void)startDeg; (void)intervalDeg;
+        return count == 0;
+    }
+    
     // Callback functions for events (optional, can be nullptr)
     std::function<void()> onConnected;
     std::function<void()> onDisconnected;
     std::function<void()> onMovementStarted;
     std::function<void()> onMovementStopped;
     std::function<void(double, double, double)> onPositionChanged;
+    // Same reports as onPositionChanged, stamped with the encoder read time
+    std::function<void(const PositionSample&)> onPositionSampled;
+    // Queued waypoint passed (blend) or settled at; reports its id and the
+    // encoder position at that moment
+    std::function<void(int id, double az, double el, double pol)> onWaypointReached;
     std::function<void(const std::string&)> onError;
     std::function<void(const std::vector<DeviceInfo>&)> onDevicesScanned;
 };
@@ -196,8 +417,8 @@ typedef ISignalGeneratorPlugin* (*CreateSignalGeneratorPluginFunc)();
 typedef IPositionerPlugin* (*CreatePositionerPluginFunc)();
 typedef void (*DestroyPluginFunc)(void*);
 
-#define SIGNAL_ANALYZER_PLUGIN_IID "id.co.fusi.antenna.ISignalAnalyzerPlugin/1.0"
-#define SIGNAL_GENERATOR_PLUGIN_IID "id.co.fusi.antenna.ISignalGeneratorPlugin/1.0"
-#define POSITIONER_PLUGIN_IID "id.co.fusi.antenna.IPositionerPlugin/1.0"
+#define SIGNAL_ANALYZER_PLUGIN_IID "id.co.fusi.antenna.ISignalAnalyzerPlugin/2.0"
+#define SIGNAL_GENERATOR_PLUGIN_IID "id.co.fusi.antenna.ISignalGeneratorPlugin/2.0"
+#define POSITIONER_PLUGIN_IID "id.co.fusi.antenna.IPositionerPlugin/2.0"
 
 #endif // IPLUGININTERFACE_H
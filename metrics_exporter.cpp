@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Metrics Exporter
+** Renders the plugin shared-memory metrics segment in Prometheus text
+** format, either to a file or on a local HTTP port
+**
+****************************************************************************/
+
+#include "common/prometheusexporter.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+
+static void printUsage()
+{
+    std::cout << "Usage: metrics_exporter [options]" << std::endl;
+    std::cout << "  --segment NAME     Shared-memory segment (default: " << PLUGIN_METRICS_DEFAULT_SEGMENT << ")" << std::endl;
+    std::cout << "  --file PATH        Write metrics to PATH (textfile collector)" << std::endl;
+    std::cout << "  --interval-ms N    File rewrite interval (default: 5000)" << std::endl;
+    std::cout << "  --port N           Serve metrics on http://127.0.0.1:N/metrics" << std::endl;
+    std::cout << "  --once             Print the metrics once and exit" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string segmentName = PLUGIN_METRICS_DEFAULT_SEGMENT;
+    std::string filePath;
+    int intervalMs = 5000;
+    int port = 0;
+    bool once = false;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--segment" && i + 1 < argc) {
+            segmentName = argv[++i];
+        } else if (arg == "--file" && i + 1 < argc) {
+            filePath = argv[++i];
+        } else if (arg == "--interval-ms" && i + 1 < argc) {
+            intervalMs = std::atoi(argv[++i]);
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "--once") {
+            once = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    
+    // Wait for the host application to create the segment
+    MetricsSegment segment;
+    while (!segment.attach(segmentName)) {
+        if (once) {
+            std::cerr << "Metrics segment " << segmentName << " not found" << std::endl;
+            return 1;
+        }
+        std::cout << "Waiting for metrics segment " << segmentName << "..." << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+    }
+    
+    PrometheusExporter exporter(segment);
+    if (once) {
+        std::cout << exporter.render();
+        return 0;
+    }
+    
+    if (filePath.empty() && port == 0) {
+        printUsage();
+        return 1;
+    }
+    
+    // Separate exporters so file and HTTP output can run together
+    PrometheusExporter httpExporter(segment);
+    if (!filePath.empty()) {
+        exporter.startFileExport(filePath, std::chrono::milliseconds(intervalMs));
+        std::cout << "Writing metrics to " << filePath << " every " << intervalMs << " ms" << std::endl;
+    }
+    if (port != 0) {
+        if (!httpExporter.startHttpExport(static_cast<unsigned short>(port))) {
+            std::cerr << "Cannot listen on port " << port << std::endl;
+            return 1;
+        }
+        std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+    }
+    
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    return 0;
+}
@@ -26,6 +26,26 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <deque>
+#include <algorithm>
+#include <limits>
+
+// Motion simulation: fixed-rate tick of the mechanical model, adjustable
+// with setDummyPositionerTickRate. Position reports are limited to one per
+// POSITION_REPORT_INTERVAL_MS; after a stall the model catches up on at
+// most MAX_CATCH_UP_STEPS ticks. start() jogs at one Step per
+// JOG_STEP_PERIOD_S for at most JOG_DURATION_S.
+#define DEFAULT_TICK_RATE_HZ 200.0
+#define MIN_TICK_RATE_HZ 10.0
+#define MAX_TICK_RATE_HZ 2000.0
+#define POSITION_REPORT_INTERVAL_MS 10
+#define MAX_CATCH_UP_STEPS 10
+#define JOG_STEP_PERIOD_S 0.1
+#define JOG_DURATION_S 5.0
+
+// Commands pending between two simulation ticks. Waypoints move on into
+// the path of the movement thread every tick, so paths are not limited by it.
+#define MOTION_QUEUE_CAPACITY 1024
 
 DummyPositioner::DummyPositioner()
     : m_isConnected(false)
@@ -36,7 +56,20 @@ DummyPositioner::DummyPositioner()
     , m_currentPOL(0.0)
     , m_connectedAddress("")
     , m_stepCount(0)
+    , m_commands(MOTION_QUEUE_CAPACITY)
+    , m_stopTickets(0)
+    , m_stopsCompleted(0)
+    , m_quit(false)
+    , m_tickPeriodNs((int64_t)(1e9 / DEFAULT_TICK_RATE_HZ))
+    , m_loopTicks(0)
+    , m_loopOverruns(0)
+    , m_compareLine(nullptr)
+    , m_range(nullptr)
 {
+    for (int i = 0; i < AxisCount; i++) {
+        m_axes[i] = AxisSimulator(AxisModel(), i + 1);
+    }
+    
     // Initialize step with default values
     m_step.AZ = 1.0;
     m_step.EL = 1.0;
@@ -69,6 +102,8 @@ DummyPositioner::DummyPositioner()
     m_currentMovement.Y = 0.0;
     m_currentMovement.V = 0.0;
     
+    m_movementThread = std::thread(&DummyPositioner::movementThread, this);
+    
     std::cout << "[Dummy Positioner Plugin] Instance created" << std::endl;
 }
 
@@ -142,6 +177,14 @@ DummyPositioner::~DummyPositioner()
     if (m_isConnected) {
         disconnect();
     }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_quit = true;
+    }
+    m_wakeCondition.notify_all();
+    if (m_movementThread.joinable()) {
+        m_movementThread.join();
+    }
     std::cout << "[Dummy Positioner Plugin] Instance destroyed" << std::endl;
 }
 
@@ -237,6 +280,10 @@ void DummyPositioner::setMovement(const Movement &movement)
 void DummyPositioner::setDistance(double distance)
 {
     m_distance = distance;
+    VirtualRange *range = m_range;
+    if (range != nullptr) {
+        range->setDistance(distance);
+    }
     std::cout << "[Dummy Positioner Plugin] Distance set to " << distance << std::endl;
 }
 
@@ -267,63 +314,17 @@ void DummyPositioner::moveTo(double azimuth, double elevation)
     
     std::cout << "[Dummy Positioner Plugin] Moving to position: AZ=" << azimuth << "° EL=" << elevation << "°" << std::endl;
     
-    // Stop any existing movement
-    if (m_isMoving) {
-        stop();
-    }
-    
     // Calculate movement direction
     m_currentMovement.AZ = (azimuth > m_currentAZ) ? 1.0 : -1.0;
     m_currentMovement.EL = (elevation > m_currentEL) ? 1.0 : -1.0;
     m_currentMovement.POL = 0.0; // Don't change polarization
     
-    // Start movement
-    m_isMoving = true;
-    m_stepCount = 0;
-    
-    // Start movement thread with target position
-    m_movementThread = std::thread([this, azimuth, elevation]() {
-        while (m_isMoving) {
-            // Calculate distance to target
-            double azDiff = azimuth - m_currentAZ;
-            double elDiff = elevation - m_currentEL;
-            
-            // Check if we're close enough
-            if (std::abs(azDiff) < m_step.AZ && std::abs(elDiff) < m_step.EL) {
-                m_currentAZ = azimuth;
-                m_currentEL = elevation;
-                std::cout << "[Dummy Positioner Plugin] Target position reached" << std::endl;
-                m_isMoving = false;
-                break;
-            }
-            
-            // Move one step toward target
-            if (std::abs(azDiff) >= m_step.AZ) {
-                m_currentAZ += (azDiff > 0 ? m_step.AZ : -m_step.AZ);
-            }
-            if (std::abs(elDiff) >= m_step.EL) {
-                m_currentEL += (elDiff > 0 ? m_step.EL : -m_step.EL);
-            }
-            
-            m_stepCount++;
-            
-            // Emit position changed callback
-            if (onPositionChanged) {
-                onPositionChanged(m_currentAZ, m_currentEL, m_currentPOL);
-            }
-            
-            // Sleep for 100ms between steps
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        
-        if (onMovementStopped) {
-            onMovementStopped();
-        }
-    });
-    
-    if (onMovementStarted) {
-        onMovementStarted();
-    }
+    // Retargets a running motion without stopping first
+    MotionCommand command;
+    command.type = MotionCommand::Move;
+    command.waypoint = Waypoint(azimuth, elevation, 0.0, false, 0);
+    command.movePolar = false;
+    postCommand(command);
 }
 
 void DummyPositioner::moveTo(double azimuth, double elevation, double polar)
@@ -338,68 +339,42 @@ void DummyPositioner::moveTo(double azimuth, double elevation, double polar)
     
     std::cout << "[Dummy Positioner Plugin] Moving to position: AZ=" << azimuth << "° EL=" << elevation << "° POL=" << polar << "°" << std::endl;
     
-    // Stop any existing movement
-    if (m_isMoving) {
-        stop();
-    }
-    
     // Calculate movement direction
     m_currentMovement.AZ = (azimuth > m_currentAZ) ? 1.0 : -1.0;
     m_currentMovement.EL = (elevation > m_currentEL) ? 1.0 : -1.0;
     m_currentMovement.POL = (polar > m_currentPOL) ? 1.0 : -1.0;
     
-    // Start movement
-    m_isMoving = true;
-    m_stepCount = 0;
-    
-    // Start movement thread with target position
-    m_movementThread = std::thread([this, azimuth, elevation, polar]() {
-        while (m_isMoving) {
-            // Calculate distance to target
-            double azDiff = azimuth - m_currentAZ;
-            double elDiff = elevation - m_currentEL;
-            double polDiff = polar - m_currentPOL;
-            
-            // Check if we're close enough
-            if (std::abs(azDiff) < m_step.AZ && std::abs(elDiff) < m_step.EL && std::abs(polDiff) < m_step.POL) {
-                m_currentAZ = azimuth;
-                m_currentEL = elevation;
-                m_currentPOL = polar;
-                std::cout << "[Dummy Positioner Plugin] Target position reached" << std::endl;
-                m_isMoving = false;
-                break;
-            }
-            
-            // Move one step toward target
-            if (std::abs(azDiff) >= m_step.AZ) {
-                m_currentAZ += (azDiff > 0 ? m_step.AZ : -m_step.AZ);
-            }
-            if (std::abs(elDiff) >= m_step.EL) {
-                m_currentEL += (elDiff > 0 ? m_step.EL : -m_step.EL);
-            }
-            if (std::abs(polDiff) >= m_step.POL) {
-                m_currentPOL += (polDiff > 0 ? m_step.POL : -m_step.POL);
-            }
-            
-            m_stepCount++;
-            
-            // Emit position changed callback
-            if (onPositionChanged) {
-                onPositionChanged(m_currentAZ, m_currentEL, m_currentPOL);
-            }
-            
-            // Sleep for 100ms between steps
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-        
-        if (onMovementStopped) {
-            onMovementStopped();
+    MotionCommand command;
+    command.type = MotionCommand::Move;
+    command.waypoint = Waypoint(azimuth, elevation, polar, false, 0);
+    command.movePolar = true;
+    postCommand(command);
+}
+
+bool DummyPositioner::queueWaypoints(const std::vector<Waypoint> &waypoints)
+{
+    if (!m_isConnected) {
+        std::cerr << "[Dummy Positioner Plugin] Cannot queue waypoints - not connected" << std::endl;
+        if (onError) {
+            onError("Positioner not connected");
         }
-    });
+        return false;
+    }
     
-    if (onMovementStarted) {
-        onMovementStarted();
+    std::vector<MotionCommand> commands(waypoints.size());
+    for (size_t i = 0; i < waypoints.size(); i++) {
+        commands[i].type = MotionCommand::Path;
+        commands[i].waypoint = waypoints[i];
     }
+    if (!postCommands(commands)) {
+        std::cerr << "[Dummy Positioner Plugin] Motion queue full, path of " << waypoints.size()
+                  << " waypoints not queued" << std::endl;
+        if (onError) {
+            onError("Positioner motion queue full");
+        }
+        return false;
+    }
+    return true;
 }
 
 void DummyPositioner::start()
@@ -420,17 +395,17 @@ void DummyPositioner::start()
     std::cout << "[Dummy Positioner Plugin] Starting movement..." << std::endl;
     std::cout << "  From position: AZ=" << m_currentAZ << " EL=" << m_currentEL << " POL=" << m_currentPOL << std::endl;
     
-    m_isMoving = true;
-    m_stepCount = 0;
-    
-    // Start movement thread
-    m_movementThread = std::thread(&DummyPositioner::movementThread, this);
-    
-    if (onMovementStarted) {
-        onMovementStarted();
-    }
+    // Jog in the Movement direction at one Step per JOG_STEP_PERIOD_S
+    MotionCommand command;
+    command.type = MotionCommand::Jog;
+    command.jogVelocity[AxisAZ] = m_currentMovement.AZ * m_step.AZ / JOG_STEP_PERIOD_S;
+    command.jogVelocity[AxisEL] = m_currentMovement.EL * m_step.EL / JOG_STEP_PERIOD_S;
+    command.jogVelocity[AxisPOL] = m_currentMovement.POL * m_step.POL / JOG_STEP_PERIOD_S;
+    postCommand(command);
 }
 
+// Decelerates all axes and returns once the positioner is at rest. From a
+// callback on the movement thread it only requests the stop.
 void DummyPositioner::stop()
 {
     if (!m_isMoving) {
@@ -440,69 +415,447 @@ void DummyPositioner::stop()
     
     std::cout << "[Dummy Positioner Plugin] Stopping movement..." << std::endl;
     
-    m_isMoving = false;
+    MotionCommand command;
+    command.type = MotionCommand::Stop;
+    command.stopTicket = ++m_stopTickets;
+    if (!postCommand(command) || onMotionThread()) {
+        return;
+    }
     
-    // Wait for movement thread to finish
-    if (m_movementThread.joinable()) {
-        m_movementThread.join();
+    // Wait for the movement thread to bring the axes to rest
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_stoppedCondition.wait(lock, [&]() { return m_stopsCompleted >= command.stopTicket || m_quit; });
     }
     
     std::cout << "  Final position: AZ=" << m_currentAZ << " EL=" << m_currentEL << " POL=" << m_currentPOL << std::endl;
     std::cout << "  Steps taken: " << m_stepCount << std::endl;
+}
+
+bool DummyPositioner::setAxisModel(PositionerAxis axis, const AxisModel &model)
+{
+    if (axis < 0 || axis >= AxisCount) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_axisMutex);
+    m_axes[axis].setModel(model);
+    std::cout << "[Dummy Positioner Plugin] Axis " << axis << " model set: " << model.maxVelocity << " deg/s, "
+              << model.maxAcceleration << " deg/s^2, backlash " << model.backlashDeg << " deg" << std::endl;
+    return true;
+}
+
+bool DummyPositioner::setPositionCompare(int axis, double startDeg, double intervalDeg, unsigned int count)
+{
+    if (axis < 0 || axis >= AxisCount || (count > 1 && intervalDeg == 0.0)) {
+        std::cerr << "[Dummy Positioner Plugin] Invalid position compare: axis " << axis
+                  << ", interval " << intervalDeg << " deg" << std::endl;
+        return false;
+    }
     
-    if (onMovementStopped) {
-        onMovementStopped();
+    std::lock_guard<std::mutex> lock(m_axisMutex);
+    m_compare.axis = axis;
+    m_compare.startDeg = startDeg;
+    m_compare.intervalDeg = intervalDeg;
+    m_compare.count = count;
+    m_compare.next = 0;
+    if (count > 0) {
+        std::cout << "[Dummy Positioner Plugin] Position compare on axis " << axis << ": " << count
+                  << " points from " << startDeg << " deg every " << intervalDeg << " deg" << std::endl;
+    } else {
+        std::cout << "[Dummy Positioner Plugin] Position compare disabled" << std::endl;
+    }
+    return true;
+}
+
+void DummyPositioner::attachTriggerLine(TriggerLine *triggerOut)
+{
+    m_compareLine = triggerOut;
+    std::cout << "[Dummy Positioner Plugin] Compare out: " << (triggerOut ? triggerOut->name() : "not connected") << std::endl;
+}
+
+void DummyPositioner::attachVirtualRange(VirtualRange *range)
+{
+    if (range != nullptr) {
+        std::lock_guard<std::mutex> lock(m_axisMutex);
+        range->setPosition(m_axes[AxisAZ].loadPosition(), m_axes[AxisEL].loadPosition(), m_axes[AxisPOL].loadPosition());
+        range->setDistance(m_distance);
+    }
+    m_range = range;
+    std::cout << "[Dummy Positioner Plugin] Virtual range " << (range ? "attached" : "detached") << std::endl;
+}
+
+bool DummyPositioner::setTickRate(double rateHz)
+{
+    if (!(rateHz >= MIN_TICK_RATE_HZ && rateHz <= MAX_TICK_RATE_HZ)) {
+        std::cerr << "[Dummy Positioner Plugin] Tick rate must be " << MIN_TICK_RATE_HZ << " to "
+                  << MAX_TICK_RATE_HZ << " Hz" << std::endl;
+        return false;
+    }
+    m_tickPeriodNs = (int64_t)(1e9 / rateHz);
+    resetLoopStats();
+    std::cout << "[Dummy Positioner Plugin] Motion loop tick rate set to " << rateHz << " Hz" << std::endl;
+    return true;
+}
+
+MotionLoopStats DummyPositioner::loopStats() const
+{
+    LatencyHistogram::Snapshot lateness = m_loopLateness.snapshot();
+    MotionLoopStats stats;
+    stats.tickRateHz = 1e9 / (double)m_tickPeriodNs.load();
+    stats.ticks = m_loopTicks;
+    stats.overruns = m_loopOverruns;
+    stats.meanLatenessUs = lateness.meanNs() / 1000.0;
+    stats.p99LatenessUs = lateness.percentileNs(0.99) / 1000.0;
+    stats.maxLatenessUs = lateness.maxNs / 1000.0;
+    return stats;
+}
+
+void DummyPositioner::resetLoopStats()
+{
+    m_loopLateness.reset();
+    m_loopTicks = 0;
+    m_loopOverruns = 0;
+}
+
+// Marks the positioner as moving before the command is seen, so stop()
+// right after a move is not ignored. The queue only fills up if the caller
+// outpaces the simulation tick; producers then wait for it to drain, except
+// on the movement thread itself.
+bool DummyPositioner::postCommand(const MotionCommand &command)
+{
+    if (command.type != MotionCommand::Stop) {
+        m_isMoving = true;
+    }
+    while (!m_commands.push(command)) {
+        if (onMotionThread() || m_quit) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
     }
+    m_wakeCondition.notify_one();
+    return true;
+}
+
+// Posts commands in order. On the movement thread, where the queue cannot
+// drain, they are queued completely or not at all.
+bool DummyPositioner::postCommands(const std::vector<MotionCommand> &commands)
+{
+    if (!onMotionThread()) {
+        for (const MotionCommand &command : commands) {
+            if (!postCommand(command)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (!m_commands.pushAll(commands.data(), commands.size())) {
+        return false;
+    }
+    if (!commands.empty()) {
+        m_isMoving = true;
+    }
+    return true;
 }
 
+bool DummyPositioner::onMotionThread() const
+{
+    return std::this_thread::get_id() == m_movementThread.get_id();
+}
+
+// Persistent fixed-rate simulation of all axes. Sleeps while idle; while
+// moving it drains the command queue every tick and walks the queued path.
+// A blended waypoint is left for the next one as soon as every axis reaches
+// its braking point, so the axes keep their speed through it; its arrival
+// is reported when the motors pass closest to it.
 void DummyPositioner::movementThread()
 {
-    while (m_isMoving) {
-        // Update position based on movement and step
-        double nextAZ = m_currentAZ + (m_currentMovement.AZ * m_step.AZ);
-        double nextEL = m_currentEL + (m_currentMovement.EL * m_step.EL);
-        double nextPOL = m_currentPOL + (m_currentMovement.POL * m_step.POL);
-        
-        // Check bounds
-        if (nextAZ < m_minRange.AZ || nextAZ > m_maxRange.AZ) {
-            std::cout << "[Dummy Positioner Plugin] AZ limit reached: " << nextAZ << std::endl;
-            m_isMoving = false;
-            break;
+    typedef std::chrono::steady_clock Clock;
+    const char *axisNames[AxisCount] = { "AZ", "EL", "POL" };
+    const auto reportInterval = std::chrono::milliseconds(POSITION_REPORT_INTERVAL_MS);
+    
+    std::deque<Waypoint> path;
+    std::deque<std::pair<Waypoint, double>> passing;  // left, not yet passed
+    bool pathTargetSet = false;
+    bool active = false;
+    bool jogging = false;
+    bool interrupted = false;
+    uint64_t stopTicket = 0;
+    auto jogEnd = Clock::now();
+    auto deadline = Clock::now();
+    auto lastReport = Clock::now();
+    std::vector<Waypoint> reached;
+    
+    while (!m_quit) {
+        // Sleep until the next tick deadline (idle: until a command
+        // arrives). A new command cuts the wait short and is applied at
+        // once; the simulation itself only steps on the deadlines.
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            auto commandPending = [&]() { return m_quit || !m_commands.empty(); };
+            if (active) {
+                m_wakeCondition.wait_until(lock, deadline, commandPending);
+            } else {
+                m_wakeCondition.wait(lock, commandPending);
+            }
+            if (m_quit) {
+                break;
+            }
         }
         
-        if (nextEL < m_minRange.EL || nextEL > m_maxRange.EL) {
-            std::cout << "[Dummy Positioner Plugin] EL limit reached: " << nextEL << std::endl;
-            m_isMoving = false;
-            break;
+        bool started = false;
+        bool stopped = false;
+        bool report = false;
+        bool settled = true;
+        uint64_t sampleNs = 0;
+        unsigned int comparePulses = 0;
+        reached.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_axisMutex);
+            const double minRange[AxisCount] = { m_minRange.AZ, m_minRange.EL, m_minRange.POL };
+            const double maxRange[AxisCount] = { m_maxRange.AZ, m_maxRange.EL, m_maxRange.POL };
+    
+            MotionCommand command;
+            while (m_commands.pop(command)) {
+                switch (command.type) {
+                case MotionCommand::Move:
+                    path.clear();
+                    passing.clear();
+                    pathTargetSet = false;
+                    jogging = false;
+                    m_axes[AxisAZ].moveTo(command.waypoint.AZ);
+                    m_axes[AxisEL].moveTo(command.waypoint.EL);
+                    if (command.movePolar) {
+                        m_axes[AxisPOL].moveTo(command.waypoint.POL);
+                    }
+                    break;
+                case MotionCommand::Path:
+                    if (jogging) {
+                        jogging = false;
+                        for (auto &axis : m_axes) {
+                            axis.stop();
+                        }
+                    }
+                    path.push_back(command.waypoint);
+                    break;
+                case MotionCommand::Jog:
+                    path.clear();
+                    passing.clear();
+                    pathTargetSet = false;
+                    jogging = true;
+                    jogEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds((int)(JOG_DURATION_S * 1000));
+                    for (int i = 0; i < AxisCount; i++) {
+                        m_axes[i].jog(command.jogVelocity[i]);
+                    }
+                    break;
+                case MotionCommand::Stop:
+                    path.clear();
+                    passing.clear();
+                    pathTargetSet = false;
+                    jogging = false;
+                    interrupted = true;
+                    for (auto &axis : m_axes) {
+                        axis.stop();
+                    }
+                    stopTicket = command.stopTicket;
+                    break;
+                }
+                if (!active && command.type != MotionCommand::Stop) {
+                    active = true;
+                    started = true;
+                    interrupted = false;
+                    m_stepCount = 0;
+                    deadline = Clock::now();
+                }
+            }
+            
+            // Ticks missed by more than a period are overruns; the model
+            // catches up on them so simulated time keeps pace with the clock
+            Clock::time_point now = Clock::now();
+            bool tick = active && now >= deadline;
+            int steps = 0;
+            const auto period = std::chrono::nanoseconds(m_tickPeriodNs.load());
+            const double dt = std::chrono::duration<double>(period).count();
+            if (tick) {
+                auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline);
+                int64_t due = lateness / period + 1;
+                steps = (int)std::min<int64_t>(due, MAX_CATCH_UP_STEPS);
+                deadline += due * period;
+                m_loopLateness.record(lateness.count());
+                m_loopTicks++;
+                m_loopOverruns += due - 1;
+            }
+    
+            if (tick && jogging && now >= jogEnd) {
+                std::cout << "[Dummy Positioner Plugin] Movement completed (" << JOG_DURATION_S << " s jog)" << std::endl;
+                jogging = false;
+                for (auto &axis : m_axes) {
+                    axis.stop();
+                }
+            }
+    
+            // Walk the path, possibly through several blended waypoints
+            while (tick && !path.empty()) {
+                const Waypoint &waypoint = path.front();
+                if (!pathTargetSet) {
+                    m_axes[AxisAZ].moveTo(waypoint.AZ);
+                    m_axes[AxisEL].moveTo(waypoint.EL);
+                    m_axes[AxisPOL].moveTo(waypoint.POL);
+                    pathTargetSet = true;
+                }
+                // The last waypoint is settled at even if it blends, unless
+                // the next one is queued before the axes get there
+                bool arrived = true;
+                for (auto &axis : m_axes) {
+                    bool done = (waypoint.blend && path.size() > 1) ? axis.isBlendable() : axis.isSettled();
+                    arrived = arrived && done;
+                }
+                if (!arrived) {
+                    break;
+                }
+                if (waypoint.blend && path.size() > 1) {
+                    passing.push_back(std::make_pair(waypoint, std::numeric_limits<double>::max()));
+                } else {
+                    for (auto &left : passing) {
+                        reached.push_back(left.first);
+                    }
+                    passing.clear();
+                    reached.push_back(waypoint);
+                }
+                path.pop_front();
+                pathTargetSet = false;
+            }
+    
+            if (tick) {
+                for (int i = 0; i < AxisCount; i++) {
+                    AxisSimulator &axis = m_axes[i];
+                    double previousLoad = axis.loadPosition();
+                    for (int n = 0; n < steps; n++) {
+                        axis.step(dt);
+                    }
+                    
+                    // Compare points the load passed during this tick
+                    while (i == m_compare.axis && m_compare.next < m_compare.count) {
+                        double point = m_compare.startDeg + m_compare.next * m_compare.intervalDeg;
+                        double load = axis.loadPosition();
+                        if (point < std::min(previousLoad, load) || point > std::max(previousLoad, load)) {
+                            break;
+                        }
+                        m_compare.next++;
+                        comparePulses++;
+                    }
+    
+                    // Soft limits: decelerate and drop the path when an axis leaves its range
+                    double position = axis.motorPosition();
+                    double velocity = axis.motorVelocity();
+                    if ((position < minRange[i] && velocity < 0.0) || (position > maxRange[i] && velocity > 0.0)) {
+                        std::cout << "[Dummy Positioner Plugin] " << axisNames[i] << " limit reached: " << position << std::endl;
+                        path.clear();
+                        passing.clear();
+                        pathTargetSet = false;
+                        jogging = false;
+                        for (auto &other : m_axes) {
+                            other.stop();
+                        }
+                        interrupted = true;
+                    }
+                    settled = settled && axis.isSettled();
+                }
+                settled = settled && path.empty() && !jogging;
+                
+                // A blended waypoint is passed once the distance to it
+                // stops shrinking
+                while (!passing.empty()) {
+                    const Waypoint &waypoint = passing.front().first;
+                    double distance = std::max(std::abs(m_axes[AxisAZ].motorPosition() - waypoint.AZ),
+                                               std::max(std::abs(m_axes[AxisEL].motorPosition() - waypoint.EL),
+                                                        std::abs(m_axes[AxisPOL].motorPosition() - waypoint.POL)));
+                    if (distance > m_axes[AxisAZ].model().settleToleranceDeg && distance < passing.front().second) {
+                        passing.front().second = distance;
+                        break;
+                    }
+                    reached.push_back(waypoint);
+                    passing.pop_front();
+                }
+    
+                m_currentAZ = m_axes[AxisAZ].readEncoder();
+                m_currentEL = m_axes[AxisEL].readEncoder();
+                m_currentPOL = m_axes[AxisPOL].readEncoder();
+                sampleNs = steadyClockNs();
+                m_stepCount++;
+                
+                // The antenna sits on the load, whatever the encoders read
+                VirtualRange *range = m_range;
+                if (range != nullptr) {
+                    range->setPosition(m_axes[AxisAZ].loadPosition(), m_axes[AxisEL].loadPosition(),
+                                       m_axes[AxisPOL].loadPosition());
+                }
+                
+                // Position reports are decimated at high tick rates
+                report = settled || now - lastReport + period / 2 >= reportInterval;
+                if (report) {
+                    lastReport = now;
+                }
+            }
         }
-        
-        if (nextPOL < m_minRange.POL || nextPOL > m_maxRange.POL) {
-            std::cout << "[Dummy Positioner Plugin] POL limit reached: " << nextPOL << std::endl;
-            m_isMoving = false;
-            break;
+    
+        TriggerLine *compareLine = m_compareLine;
+        for (unsigned int n = 0; compareLine != nullptr && n < comparePulses; n++) {
+            compareLine->fire();
         }
         
-        // Update position
-        m_currentAZ = nextAZ;
-        m_currentEL = nextEL;
-        m_currentPOL = nextPOL;
-        m_stepCount++;
-        
-        // Emit position changed callback
-        if (onPositionChanged) {
-            onPositionChanged(m_currentAZ, m_currentEL, m_currentPOL);
+        if (started) {
+            m_isMoving = true;
+            if (onMovementStarted) {
+                onMovementStarted();
+            }
         }
-        
-        // Check if we've moved the specified distance (for demo, stop after 50 steps)
-        if (m_stepCount >= 50) {
-            std::cout << "[Dummy Positioner Plugin] Movement completed (50 steps)" << std::endl;
-            m_isMoving = false;
-            break;
+        if (onWaypointReached) {
+            for (const Waypoint &waypoint : reached) {
+                onWaypointReached(waypoint.id, m_currentAZ, m_currentEL, m_currentPOL);
+            }
+        }
+    
+        if (report) {
+            // Emit position changed callback
+            if (onPositionChanged) {
+                onPositionChanged(m_currentAZ, m_currentEL, m_currentPOL);
+            }
+            if (onPositionSampled) {
+                onPositionSampled(PositionSample(m_currentAZ, m_currentEL, m_currentPOL, sampleNs));
+            }
+    
+            if (settled) {
+                active = false;
+                stopped = true;
+                if (!interrupted) {
+                    std::cout << "[Dummy Positioner Plugin] Target position reached" << std::endl;
+                }
+                if (m_commands.empty()) {
+                    m_isMoving = false;
+                }
+            }
+        }
+    
+        // A stop is complete once the axes are at rest (immediately if idle)
+        if (stopTicket != 0 && !active) {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_stopsCompleted = stopTicket;
+            }
+            m_stoppedCondition.notify_all();
+            stopTicket = 0;
+        }
+    
+        if (stopped && onMovementStopped) {
+            onMovementStopped();
         }
-        
-        // Sleep for 100ms between steps
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_stoppedCondition.notify_all();
 }
 
 // Factory function to create plugin instance
@@ -524,4 +877,77 @@ extern "C" {
         std::cout << "[Dummy Positioner Plugin] Factory: Destroying plugin instance" << std::endl;
         delete static_cast<IPositionerPlugin*>(plugin);
     }
+    
+    // Mechanical model of one axis (see common/motionmodel.h). plugin must
+    // be the instance returned by createPositionerPlugin, not a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool setDummyPositionerAxisModel(IPositionerPlugin* plugin, int axis, const AxisModel* model)
+    {
+        DummyPositioner *positioner = dynamic_cast<DummyPositioner*>(plugin);
+        if (positioner == nullptr || model == nullptr) {
+            return false;
+        }
+        return positioner->setAxisModel(static_cast<PositionerAxis>(axis), *model);
+    }
+    
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool setDummyPositionerTickRate(IPositionerPlugin* plugin, double rateHz)
+    {
+        DummyPositioner *positioner = dynamic_cast<DummyPositioner*>(plugin);
+        if (positioner == nullptr) {
+            return false;
+        }
+        return positioner->setTickRate(rateHz);
+    }
+    
+    // Timing of the motion loop since the last reset (or tick rate change)
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool getDummyPositionerLoopStats(IPositionerPlugin* plugin, MotionLoopStats* stats, bool reset)
+    {
+        DummyPositioner *positioner = dynamic_cast<DummyPositioner*>(plugin);
+        if (positioner == nullptr || stats == nullptr) {
+            return false;
+        }
+        *stats = positioner->loopStats();
+        if (reset) {
+            positioner->resetLoopStats();
+        }
+        return true;
+    }
+    
+    // Position-compare output of the simulated trigger bus (see
+    // common/triggerbus.h). plugin must not be a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummyPositionerTriggerLine(IPositionerPlugin* plugin, TriggerLine* triggerOut)
+    {
+        DummyPositioner *positioner = dynamic_cast<DummyPositioner*>(plugin);
+        if (positioner == nullptr) {
+            return false;
+        }
+        positioner->attachTriggerLine(triggerOut);
+        return true;
+    }
+    
+    // Simulated antenna range (see common/virtualrange.h). plugin must not
+    // be a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummyPositionerVirtualRange(IPositionerPlugin* plugin, VirtualRange* range)
+    {
+        DummyPositioner *positioner = dynamic_cast<DummyPositioner*>(plugin);
+        if (positioner == nullptr) {
+            return false;
+        }
+        positioner->attachVirtualRange(range);
+        return true;
+    }
 }
@@ -25,10 +25,17 @@
 #define DUMMYPOSITIONER_H
 
 #include "iplugininterface.h"
+#include "common/motionmodel.h"
+#include "common/mpscqueue.h"
+#include "common/latencyhistogram.h"
+#include "common/triggerbus.h"
+#include "common/virtualrange.h"
 #include <string>
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 class DummyPositioner : public IPositionerPlugin
 {
@@ -64,9 +71,54 @@ public:
     void stop() override;
     void moveTo(double azimuth, double elevation) override;
     void moveTo(double azimuth, double elevation, double polar) override;
+    bool queueWaypoints(const std::vector<Waypoint> &waypoints) override;
+    bool setPositionCompare(int axis, double startDeg, double intervalDeg, unsigned int count) override;
+    
+    // Position-compare output line (also exported as
+    // attachDummyPositionerTriggerLine); nullptr disconnects it
+    void attachTriggerLine(TriggerLine *triggerOut);
+    
+    // Simulated range whose antenna under test is mounted here (also
+    // exported as attachDummyPositionerVirtualRange); nullptr detaches it
+    void attachVirtualRange(VirtualRange *range);
+    
+    // Mechanical model (also exported as setDummyPositionerAxisModel)
+    bool setAxisModel(PositionerAxis axis, const AxisModel &model);
+    
+    // Motion loop timing (also exported as setDummyPositionerTickRate and
+    // getDummyPositionerLoopStats)
+    bool setTickRate(double rateHz);
+    MotionLoopStats loopStats() const;
+    void resetLoopStats();
     
 private:
+    // Request to the motion thread
+    struct MotionCommand {
+        enum Type { Move, Path, Jog, Stop };
+        Type type;
+        Waypoint waypoint;              // Move and Path target
+        bool movePolar;                 // Move: POL axis is commanded too
+        double jogVelocity[AxisCount];  // Jog
+        uint64_t stopTicket;            // Stop
+        
+        MotionCommand() : type(Stop), movePolar(false), jogVelocity{ 0.0, 0.0, 0.0 }, stopTicket(0) {}
+    };
+    
+    // Armed compare points; next is the index of the next one to pass
+    struct PositionCompare {
+        int axis;
+        double startDeg;
+        double intervalDeg;
+        unsigned int count;
+        unsigned int next;
+        
+        PositionCompare() : axis(AxisAZ), startDeg(0.0), intervalDeg(0.0), count(0), next(0) {}
+    };
+    
     void movementThread();
+    bool postCommand(const MotionCommand &command);
+    bool postCommands(const std::vector<MotionCommand> &commands);
+    bool onMotionThread() const;
     
     bool m_isConnected;
     std::atomic<bool> m_isMoving;
@@ -77,13 +129,40 @@ private:
     double m_distance;
     std::string m_connectedAddress;
     
-    // Current position
-    double m_currentAZ;
-    double m_currentEL;
-    double m_currentPOL;
+    // Current position (encoder readings)
+    std::atomic<double> m_currentAZ;
+    std::atomic<double> m_currentEL;
+    std::atomic<double> m_currentPOL;
     
-    std::thread m_movementThread;
     int m_stepCount;
+    
+    // Mechanical simulation, shared with the movement thread
+    std::mutex m_axisMutex;
+    AxisSimulator m_axes[AxisCount];
+    
+    // Persistent movement thread and its command queue. stop() waits
+    // until the thread has completed its ticket.
+    MpscQueue<MotionCommand> m_commands;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_stoppedCondition;
+    std::atomic<uint64_t> m_stopTickets;
+    uint64_t m_stopsCompleted;
+    std::atomic<bool> m_quit;
+    
+    // Tick period and lateness of each tick against its deadline
+    std::atomic<int64_t> m_tickPeriodNs;
+    LatencyHistogram m_loopLateness;
+    std::atomic<uint64_t> m_loopTicks;
+    std::atomic<uint64_t> m_loopOverruns;
+    
+    // Position compare, guarded by m_axisMutex; edges are fired outside it
+    PositionCompare m_compare;
+    std::atomic<TriggerLine*> m_compareLine;
+    
+    // Receives the load angles every tick
+    std::atomic<VirtualRange*> m_range;
+    std::thread m_movementThread;
 };
 
 #endif // DUMMYPOSITIONER_H
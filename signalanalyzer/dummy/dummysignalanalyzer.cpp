@@ -26,6 +26,25 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+
+// Swept analyzer model: sweep time = k * span / RBW^2 plus a fixed
+// overhead per sweep, with a fixed number of trace points
+#define SWEEP_TIME_FACTOR 2.5
+#define SWEEP_OVERHEAD_S 0.005
+#define SWEEP_POINTS 1001
+
+// Displayed average noise level
+#define NOISE_DENSITY_DBM_HZ -160.0
+
+// Zero span: capture length limit, and how often the received level is
+// read while capturing
+#define ZERO_SPAN_MAX_SAMPLES 1000000
+#define ZERO_SPAN_UPDATE_S 0.001
+
+// findPeakFast(): span reduction per zoom step and span/RBW ratio
+#define ZOOM_FACTOR 20.0
+#define ZOOM_SPAN_RBW_RATIO 100.0
 
 DummySignalAnalyzer::DummySignalAnalyzer()
     : m_isConnected(false)
@@ -33,6 +52,14 @@ DummySignalAnalyzer::DummySignalAnalyzer()
     , m_stopFreqHz(5560.0e6)   // 5560 MHz default (100 MHz span)
     , m_rbwHz(1.0e6)           // 1 MHz default
     , m_connectedAddress("")
+    , m_hasTone(false)
+    , m_toneFreqHz(0.0)
+    , m_toneLeveldBm(-50.0)
+    , m_triggerIn(TriggerInMode::Software)
+    , m_triggerTimeoutS(1.0)
+    , m_triggerInLine(nullptr)
+    , m_triggerSeen(0)
+    , m_range(nullptr)
 {
     // Initialize random generator with current time
     m_randomGenerator.seed(std::chrono::system_clock::now().time_since_epoch().count());
@@ -201,21 +228,76 @@ Peak DummySignalAnalyzer::findPeak()
         return peak;
     }
     
-    // Simulate measurement with realistic behavior
-    // Generate a peak somewhere in the frequency range with some randomness
-    double freqRange = m_stopFreqHz - m_startFreqHz;
-    double centerFreq = m_startFreqHz + freqRange / 2.0;
+    uint64_t sweepStartNs = 0;
+    if (!waitForTrigger(sweepStartNs)) {
+        return peak;
+    }
+    peak = sweep(m_startFreqHz, m_stopFreqHz, m_rbwHz, sweepStartNs);
     
-    // Add some randomness around center (simulate slight variations)
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    double randomOffset = (dist(m_randomGenerator) - 0.5) * freqRange * 0.2;
-    peak.frequencyHz = centerFreq + randomOffset;
+    std::cout << "[Dummy SA Plugin] Peak found at " 
+             << peak.frequencyHz / 1e6 << " MHz, "
+             << peak.leveldBm << " dBm" << std::endl;
     
-    // Generate realistic power level with some noise
-    // Base level around -50 dBm with ±10 dB variation
-    peak.leveldBm = -50.0 + (dist(m_randomGenerator) - 0.5) * 20.0;
+    if (onPeakFound) {
+        onPeakFound(peak);
+    }
+    return peak;
+}
+
+Peak DummySignalAnalyzer::findPeakFast(double targetAccuracyHz)
+{
+    Peak peak;
+    peak.frequencyHz = 0.0;
+    peak.leveldBm = -100.0;
     
-    std::cout << "[Dummy SA Plugin] Peak found at " 
+    if (!m_isConnected) {
+        std::cerr << "[Dummy SA Plugin] Cannot find peak - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Analyzer not connected");
+        }
+        return peak;
+    }
+    
+    // Zoom sweeps cannot follow an external trigger source
+    if (m_triggerIn != TriggerInMode::Software) {
+        return findPeak();
+    }
+    
+    auto startTime = std::chrono::steady_clock::now();
+    double fullSweepS = sweepTimeSeconds(m_stopFreqHz - m_startFreqHz, m_rbwHz);
+    
+    // Wide sweep with an RBW matched to the span, then zoom in on the peak
+    // until the trace point spacing reaches the requested accuracy. The
+    // configured RBW is the narrowest one used.
+    double startHz = m_startFreqHz;
+    double stopHz = m_stopFreqHz;
+    int steps = 0;
+    while (true) {
+        double span = stopHz - startHz;
+        double rbw = std::max(m_rbwHz, span / ZOOM_SPAN_RBW_RATIO);
+        peak = sweep(startHz, stopHz, rbw, steadyClockNs());
+        steps++;
+        
+        double pointSpacing = span / (SWEEP_POINTS - 1);
+        if (pointSpacing <= targetAccuracyHz) {
+            break;
+        }
+        
+        // Keep the peak, its point spacing and the RBW inside the new span
+        double newSpan = std::max(span / ZOOM_FACTOR, 4.0 * (pointSpacing + rbw));
+        if (newSpan >= span) {
+            break;
+        }
+        startHz = std::max(m_startFreqHz, peak.frequencyHz - newSpan / 2.0);
+        stopHz = std::min(m_stopFreqHz, startHz + newSpan);
+        startHz = stopHz - newSpan;
+    }
+    
+    double elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "[Dummy SA Plugin] Fast peak search: " << steps << " sweeps, "
+              << elapsedS * 1e3 << " ms (full sweep at configured RBW: "
+              << fullSweepS * 1e3 << " ms)" << std::endl;
+    std::cout << "[Dummy SA Plugin] Peak found at "
              << peak.frequencyHz / 1e6 << " MHz, "
              << peak.leveldBm << " dBm" << std::endl;
     
@@ -225,6 +307,245 @@ Peak DummySignalAnalyzer::findPeak()
     return peak;
 }
 
+bool DummySignalAnalyzer::readTrace(Trace &trace)
+{
+    if (!m_isConnected) {
+        std::cerr << "[Dummy SA Plugin] Cannot read trace - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Analyzer not connected");
+        }
+        return false;
+    }
+    
+    uint64_t sweepStartNs = 0;
+    if (!waitForTrigger(sweepStartNs)) {
+        return false;
+    }
+    
+    double sweepS = sweepTimeSeconds(m_stopFreqHz - m_startFreqHz, m_rbwHz);
+    trace.timestampNs = sweepStartNs;
+    trace.sweepTimeNs = (uint64_t)(sweepS * 1e9);
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(sweepStartNs + trace.sweepTimeNs)));
+    placeTone(m_startFreqHz, m_stopFreqHz);
+    
+    // Noise floor follows the RBW; the noise power of every point is
+    // exponentially distributed, as seen by a sample detector
+    trace.startFreqHz = m_startFreqHz;
+    trace.stopFreqHz = m_stopFreqHz;
+    trace.rbwHz = m_rbwHz;
+    trace.levelsdBm.resize(SWEEP_POINTS);
+    
+    double noisemW = std::pow(10.0, noiseFloordBm(m_rbwHz) / 10.0);
+    double tonemW = m_hasTone ? std::pow(10.0, m_toneLeveldBm / 10.0) : 0.0;
+    double pointSpacing = (m_stopFreqHz - m_startFreqHz) / (SWEEP_POINTS - 1);
+    double filterWidth = std::max(std::max(m_rbwHz, pointSpacing), 1.0);
+    std::exponential_distribution<double> noise(1.0);
+    for (int i = 0; i < SWEEP_POINTS; i++) {
+        double freq = m_startFreqHz + i * pointSpacing;
+        double offset = (freq - m_toneFreqHz) / filterWidth;
+        double levelmW = noisemW * noise(m_randomGenerator);
+        if (std::abs(offset) < 10.0) {
+            levelmW += tonemW * std::pow(10.0, -1.2 * offset * offset);
+        }
+        trace.levelsdBm[i] = 10.0 * std::log10(levelmW);
+    }
+    return true;
+}
+
+// Captured in real time: every ZERO_SPAN_UPDATE_S the received tone is
+// read (from the virtual range, it follows the positioner) and the samples
+// due by then are filled with it plus noise
+bool DummySignalAnalyzer::captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                                          ZeroSpanCapture &capture)
+{
+    if (!m_isConnected) {
+        std::cerr << "[Dummy SA Plugin] Cannot capture - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Analyzer not connected");
+        }
+        return false;
+    }
+    
+    double samplesRequested = sampleRateHz > 0.0 && durationS > 0.0 ? std::round(durationS * sampleRateHz) : 0.0;
+    if (samplesRequested < 1.0 || samplesRequested > ZERO_SPAN_MAX_SAMPLES) {
+        std::cerr << "[Dummy SA Plugin] Invalid zero-span capture: " << samplesRequested << " samples" << std::endl;
+        return false;
+    }
+    size_t samples = (size_t)samplesRequested;
+    
+    uint64_t startNs = 0;
+    if (!waitForTrigger(startNs)) {
+        return false;
+    }
+    capture.centerFreqHz = centerFreqHz;
+    capture.rbwHz = rbwHz;
+    capture.sampleRateHz = sampleRateHz;
+    capture.timestampNs = startNs;
+    capture.levelsdBm.resize(samples);
+    
+    double noisemW = std::pow(10.0, noiseFloordBm(rbwHz) / 10.0);
+    double filterWidth = std::max(rbwHz, 1.0);
+    std::exponential_distribution<double> noise(1.0);
+    const auto update = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(ZERO_SPAN_UPDATE_S));
+    const auto lastSample = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(capture.sampleTimeNs(samples - 1)));
+    size_t filled = 0;
+    while (filled < samples) {
+        uint64_t nowNs = steadyClockNs();
+        size_t due = samples;
+        if (nowNs < capture.sampleTimeNs(samples - 1)) {
+            due = nowNs < startNs ? 0 : (size_t)((double)(nowNs - startNs) * sampleRateHz / 1e9) + 1;
+        }
+        if (due > filled) {
+            placeTone(centerFreqHz - filterWidth, centerFreqHz + filterWidth);
+            double offset = (m_toneFreqHz - centerFreqHz) / filterWidth;
+            double tonemW = 0.0;
+            if (m_hasTone && std::abs(offset) < 10.0) {
+                tonemW = std::pow(10.0, (m_toneLeveldBm - 12.0 * offset * offset) / 10.0);
+            }
+            for (; filled < due; filled++) {
+                capture.levelsdBm[filled] = 10.0 * std::log10(tonemW + noisemW * noise(m_randomGenerator));
+            }
+        }
+        if (filled < samples) {
+            std::this_thread::sleep_until(std::min(std::chrono::steady_clock::now() + update, lastSample));
+        }
+    }
+    
+    std::cout << "[Dummy SA Plugin] Zero-span capture: " << samples << " samples at "
+              << centerFreqHz / 1e6 << " MHz" << std::endl;
+    return true;
+}
+
+double DummySignalAnalyzer::sweepTimeSeconds(double spanHz, double rbwHz) const
+{
+    if (rbwHz <= 0.0) {
+        return SWEEP_OVERHEAD_S;
+    }
+    return SWEEP_OVERHEAD_S + SWEEP_TIME_FACTOR * std::abs(spanHz) / (rbwHz * rbwHz);
+}
+
+void DummySignalAnalyzer::placeTone(double startFreqHz, double stopFreqHz)
+{
+    // An attached range decides what is received
+    VirtualRange *range = m_range;
+    if (range != nullptr) {
+        m_hasTone = range->receivedTone(m_toneFreqHz, m_toneLeveldBm);
+        return;
+    }
+    
+    // Otherwise place the tone somewhere around the center of the span (as a signal
+    // source tuned to the analyzer would be) if it is not inside yet
+    if (m_hasTone && m_toneFreqHz >= startFreqHz && m_toneFreqHz <= stopFreqHz) {
+        return;
+    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    double freqRange = stopFreqHz - startFreqHz;
+    double centerFreq = startFreqHz + freqRange / 2.0;
+    m_toneFreqHz = centerFreq + (dist(m_randomGenerator) - 0.5) * freqRange * 0.2;
+    // Base level around -50 dBm with ±10 dB variation
+    m_toneLeveldBm = -50.0 + (dist(m_randomGenerator) - 0.5) * 20.0;
+    m_hasTone = true;
+}
+
+Peak DummySignalAnalyzer::sweep(double startFreqHz, double stopFreqHz, double rbwHz, uint64_t sweepStartNs)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    double freqRange = stopFreqHz - startFreqHz;
+    
+    double sweepS = sweepTimeSeconds(freqRange, rbwHz);
+    uint64_t sweepEndNs = sweepStartNs + (uint64_t)(sweepS * 1e9);
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(sweepEndNs)));
+    placeTone(startFreqHz, stopFreqHz);
+    
+    // The strongest trace point is the one closest to the tone. The level
+    // drops with the offset from the tone inside the RBW filter; with RBW
+    // below the point spacing the peak detector sees the whole bin.
+    Peak peak;
+    double pointSpacing = freqRange / (SWEEP_POINTS - 1);
+    double point = pointSpacing > 0.0 ? std::round((m_toneFreqHz - startFreqHz) / pointSpacing) : 0.0;
+    point = std::min(std::max(point, 0.0), (double)(SWEEP_POINTS - 1));
+    peak.frequencyHz = startFreqHz + point * pointSpacing;
+    double offset = (peak.frequencyHz - m_toneFreqHz) / std::max(std::max(rbwHz, pointSpacing), 1.0);
+    peak.leveldBm = m_toneLeveldBm - 12.0 * offset * offset + (dist(m_randomGenerator) - 0.5) * 0.2;
+    
+    // Without a tone above it, the peak is the largest noise sample: the
+    // maximum of SWEEP_POINTS exponential powers (Gumbel distributed)
+    double u = std::min(std::max(dist(m_randomGenerator), 1e-12), 1.0 - 1e-12);
+    double noisePeakdBm = noiseFloordBm(rbwHz) + 10.0 * std::log10(std::log((double)SWEEP_POINTS) - std::log(-std::log(u)));
+    bool toneInSpan = m_hasTone && m_toneFreqHz >= startFreqHz && m_toneFreqHz <= stopFreqHz;
+    if (!toneInSpan || noisePeakdBm > peak.leveldBm) {
+        point = std::floor(dist(m_randomGenerator) * SWEEP_POINTS);
+        point = std::min(point, (double)(SWEEP_POINTS - 1));
+        peak.frequencyHz = startFreqHz + point * pointSpacing;
+        peak.leveldBm = noisePeakdBm;
+    }
+    // The sweep passes the peak bin at its share of the sweep time
+    peak.timestampNs = sweepStartNs + (uint64_t)(sweepS * 1e9 * point / (SWEEP_POINTS - 1));
+    return peak;
+}
+
+double DummySignalAnalyzer::noiseFloordBm(double rbwHz) const
+{
+    VirtualRange *range = m_range;
+    double densitydBmHz = range ? range->noiseDensitydBmHz() : NOISE_DENSITY_DBM_HZ;
+    return densitydBmHz + 10.0 * std::log10(std::max(rbwHz, 1.0));
+}
+
+bool DummySignalAnalyzer::setTriggerIn(TriggerInMode mode, double timeoutS)
+{
+    if (mode == TriggerInMode::EveryStep) {
+        std::cerr << "[Dummy SA Plugin] Trigger per step is not supported" << std::endl;
+        return false;
+    }
+    m_triggerIn = mode;
+    m_triggerTimeoutS = timeoutS;
+    
+    // Arm on edges from now on
+    TriggerLine *line = m_triggerInLine;
+    m_triggerSeen = line ? line->edgeCount() : 0;
+    std::cout << "[Dummy SA Plugin] Trigger in: " << (mode == TriggerInMode::Software ? "free run" : "external")
+              << std::endl;
+    return true;
+}
+
+void DummySignalAnalyzer::attachTriggerLine(TriggerLine *triggerIn)
+{
+    m_triggerInLine = triggerIn;
+    m_triggerSeen = triggerIn ? triggerIn->edgeCount() : 0;
+    std::cout << "[Dummy SA Plugin] Trigger in: " << (triggerIn ? triggerIn->name() : "not connected") << std::endl;
+}
+
+void DummySignalAnalyzer::attachVirtualRange(VirtualRange *range)
+{
+    m_range = range;
+    m_hasTone = false;
+    std::cout << "[Dummy SA Plugin] Virtual range " << (range ? "attached" : "detached") << std::endl;
+}
+
+// Edges are latched by the line, so an edge that arrived before the call
+// still starts the sweep at its own time
+bool DummySignalAnalyzer::waitForTrigger(uint64_t &sweepStartNs)
+{
+    if (m_triggerIn == TriggerInMode::Software) {
+        sweepStartNs = steadyClockNs();
+        return true;
+    }
+    
+    TriggerLine *line = m_triggerInLine;
+    TriggerEdge edge;
+    if (line == nullptr || !line->waitForEdge(m_triggerSeen, m_triggerTimeoutS, edge)) {
+        std::cerr << "[Dummy SA Plugin] No trigger within " << m_triggerTimeoutS << " s" << std::endl;
+        if (onError) {
+            onError("Trigger timeout");
+        }
+        return false;
+    }
+    m_triggerSeen = edge.sequence;
+    sweepStartNs = edge.timestampNs;
+    return true;
+}
+
 // Factory functions for plugin loading
 extern "C" {
     #ifdef _WIN32
@@ -244,4 +565,34 @@ extern "C" {
         std::cout << "[Dummy SA Plugin] Factory: Destroying plugin instance" << std::endl;
         delete static_cast<ISignalAnalyzerPlugin*>(plugin);
     }
+    
+    // Simulated trigger input (see common/triggerbus.h). plugin must be the
+    // instance returned by createSignalAnalyzerPlugin, not a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummySATriggerLine(ISignalAnalyzerPlugin* plugin, TriggerLine* triggerIn)
+    {
+        DummySignalAnalyzer *analyzer = dynamic_cast<DummySignalAnalyzer*>(plugin);
+        if (analyzer == nullptr) {
+            return false;
+        }
+        analyzer->attachTriggerLine(triggerIn);
+        return true;
+    }
+    
+    // Simulated antenna range (see common/virtualrange.h). plugin must be
+    // the instance returned by createSignalAnalyzerPlugin, not a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummySAVirtualRange(ISignalAnalyzerPlugin* plugin, VirtualRange* range)
+    {
+        DummySignalAnalyzer *analyzer = dynamic_cast<DummySignalAnalyzer*>(plugin);
+        if (analyzer == nullptr) {
+            return false;
+        }
+        analyzer->attachVirtualRange(range);
+        return true;
+    }
 }
@@ -25,8 +25,11 @@
 #define DUMMYSIGNALANALYZER_H
 
 #include "iplugininterface.h"
+#include "common/triggerbus.h"
+#include "common/virtualrange.h"
 #include <string>
 #include <random>
+#include <atomic>
 
 class DummySignalAnalyzer : public ISignalAnalyzerPlugin
 {
@@ -51,14 +54,52 @@ public:
     
     // Measurement
     Peak findPeak() override;
+    Peak findPeakFast(double targetAccuracyHz) override;
+    bool readTrace(Trace &trace) override;
+    bool captureZeroSpan(double centerFreqHz, double rbwHz, double sampleRateHz, double durationS,
+                         ZeroSpanCapture &capture) override;
+    
+    // External trigger input
+    bool setTriggerIn(TriggerInMode mode, double timeoutS) override;
+    
+    // Trigger line of the simulated bench (also exported as
+    // attachDummySATriggerLine); nullptr disconnects the input
+    void attachTriggerLine(TriggerLine *triggerIn);
+    
+    // Simulated range that supplies the received tone and the noise floor
+    // (also exported as attachDummySAVirtualRange); nullptr detaches it
+    void attachVirtualRange(VirtualRange *range);
     
 private:
+    // Start time of the next sweep: now, or the next trigger edge
+    bool waitForTrigger(uint64_t &sweepStartNs);
+    
+    // Simulated sweep from sweepStartNs: waits for the modeled sweep time
+    // and returns the strongest trace point
+    Peak sweep(double startFreqHz, double stopFreqHz, double rbwHz, uint64_t sweepStartNs);
+    double sweepTimeSeconds(double spanHz, double rbwHz) const;
+    void placeTone(double startFreqHz, double stopFreqHz);
+    double noiseFloordBm(double rbwHz) const;
+    
     bool m_isConnected;
     double m_startFreqHz;
     double m_stopFreqHz;
     double m_rbwHz;
     std::string m_connectedAddress;
     std::mt19937 m_randomGenerator;
+    
+    // Simulated CW tone, placed in the span on first use
+    bool m_hasTone;
+    double m_toneFreqHz;
+    double m_toneLeveldBm;
+    
+    // External trigger; edges up to m_triggerSeen are consumed
+    TriggerInMode m_triggerIn;
+    double m_triggerTimeoutS;
+    std::atomic<TriggerLine*> m_triggerInLine;
+    uint64_t m_triggerSeen;
+    
+    std::atomic<VirtualRange*> m_range;
 };
 
 #endif // DUMMYSIGNALANALYZER_H
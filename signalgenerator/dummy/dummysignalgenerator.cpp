@@ -25,6 +25,16 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <cmath>
+
+// Simulated PLL lock time: fixed part plus a part per GHz of frequency step
+#define LOCK_TIME_BASE_US 150.0
+#define LOCK_TIME_PER_GHZ_US 40.0
+
+// Simulated list mode: list length limit, and how often a sweep waiting
+// for a trigger checks for stopFreqList()
+#define LIST_MAX_POINTS 2048
+#define TRIGGER_POLL_S 0.05
 
 DummySignalGenerator::DummySignalGenerator()
     : m_isConnected(false)
@@ -32,6 +42,13 @@ DummySignalGenerator::DummySignalGenerator()
     , m_freqHz(5510.0e6)  // 5510 MHz default
     , m_powerDbm(0.0)     // 0 dBm default
     , m_connectedAddress("")
+    , m_settledMode(false)
+    , m_listStop(false)
+    , m_triggerOut(TriggerOutMode::Off)
+    , m_triggerIn(TriggerInMode::Software)
+    , m_triggerOutLine(nullptr)
+    , m_triggerInLine(nullptr)
+    , m_range(nullptr)
 {
     std::cout << "[Dummy SG Plugin] Instance created" << std::endl;
 }
@@ -111,6 +128,7 @@ bool DummySignalGenerator::connectToDevice(const std::string &address)
 
 DummySignalGenerator::~DummySignalGenerator()
 {
+    stopFreqList();
     if (m_isConnected) {
         if (m_rfEnabled) {
             disableRf();
@@ -153,6 +171,8 @@ void DummySignalGenerator::disconnect()
         return;
     }
     
+    stopFreqList();
+    
     // Turn off RF before disconnecting
     if (m_rfEnabled) {
         disableRf();
@@ -176,16 +196,33 @@ bool DummySignalGenerator::isConnected() const
 
 void DummySignalGenerator::setFreq(double freqHz)
 {
+    double stepHz = std::fabs(freqHz - m_freqHz);
     m_freqHz = freqHz;
+    publishToRange();
     std::cout << "[Dummy SG Plugin] Frequency set to " << freqHz / 1e6 << " MHz" << std::endl;
+    
+    if (m_settledMode && m_isConnected) {
+        double lockTimeUs = LOCK_TIME_BASE_US + LOCK_TIME_PER_GHZ_US * stepHz / 1e9;
+        std::this_thread::sleep_for(std::chrono::microseconds((long long)lockTimeUs));
+        if (onFreqSettled) {
+            onFreqSettled(freqHz, lockTimeUs);
+        }
+    }
 }
 
 void DummySignalGenerator::setPower(double powerDbm)
 {
     m_powerDbm = powerDbm;
+    publishToRange();
     std::cout << "[Dummy SG Plugin] Power level set to " << powerDbm << " dBm" << std::endl;
 }
 
+bool DummySignalGenerator::getPower(double &powerDbm) const
+{
+    powerDbm = m_powerDbm;
+    return true;
+}
+
 void DummySignalGenerator::enableRf()
 {
     if (!m_isConnected) {
@@ -209,6 +246,7 @@ void DummySignalGenerator::enableRf()
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
     
     m_rfEnabled = true;
+    publishToRange();
     
     std::cout << "[Dummy SG Plugin] RF output ENABLED" << std::endl;
     if (onRfEnabled) {
@@ -234,6 +272,7 @@ void DummySignalGenerator::disableRf()
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
     
     m_rfEnabled = false;
+    publishToRange();
     
     std::cout << "[Dummy SG Plugin] RF output DISABLED" << std::endl;
     if (onRfDisabled) {
@@ -246,6 +285,220 @@ bool DummySignalGenerator::isRfEnabled() const
     return m_rfEnabled;
 }
 
+bool DummySignalGenerator::setSettledMode(bool enabled, double timeoutMs)
+{
+    (void)timeoutMs;
+    m_settledMode = enabled;
+    std::cout << "[Dummy SG Plugin] Settled mode " << (enabled ? "enabled" : "disabled") << std::endl;
+    return true;
+}
+
+bool DummySignalGenerator::loadHopTable(const std::vector<double> &freqsHz)
+{
+    m_hopTable = freqsHz;
+    std::cout << "[Dummy SG Plugin] Hop table loaded (" << m_hopTable.size() << " frequencies)" << std::endl;
+    return true;
+}
+
+bool DummySignalGenerator::hopTo(size_t index)
+{
+    if (index >= m_hopTable.size() || !m_isConnected) {
+        return false;
+    }
+    m_freqHz = m_hopTable[index];
+    publishToRange();
+    return true;
+}
+
+bool DummySignalGenerator::setHopVerification(bool enabled)
+{
+    // The simulated state always matches
+    (void)enabled;
+    return true;
+}
+
+bool DummySignalGenerator::loadFreqList(const std::vector<double> &freqsHz)
+{
+    if (freqsHz.empty() || freqsHz.size() > LIST_MAX_POINTS) {
+        std::cerr << "[Dummy SG Plugin] List must have 1 to " << LIST_MAX_POINTS << " points" << std::endl;
+        return false;
+    }
+    stopFreqList();
+    m_freqList = freqsHz;
+    std::cout << "[Dummy SG Plugin] Frequency list loaded (" << m_freqList.size() << " points)" << std::endl;
+    return true;
+}
+
+bool DummySignalGenerator::startFreqList(double dwellS, unsigned int cycles)
+{
+    if (!m_isConnected) {
+        std::cerr << "[Dummy SG Plugin] Cannot start list - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Generator not connected");
+        }
+        return false;
+    }
+    if (m_freqList.empty()) {
+        std::cerr << "[Dummy SG Plugin] Cannot start list - no list loaded" << std::endl;
+        return false;
+    }
+    
+    stopFreqList();
+    m_listStop = false;
+    m_listThread = std::thread(&DummySignalGenerator::listThread, this, dwellS, cycles);
+    
+    std::cout << "[Dummy SG Plugin] List sweep " << (m_triggerIn == TriggerInMode::Software ? "started" : "armed")
+              << " (" << m_freqList.size() << " points, dwell " << dwellS * 1e3 << " ms, " << cycles << " cycles)" << std::endl;
+    return true;
+}
+
+bool DummySignalGenerator::stopFreqList()
+{
+    if (!m_listThread.joinable()) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_listMutex);
+        m_listStop = true;
+    }
+    m_listCondition.notify_all();
+    m_listThread.join();
+    std::cout << "[Dummy SG Plugin] List sweep stopped" << std::endl;
+    return true;
+}
+
+bool DummySignalGenerator::setTriggerOut(TriggerOutMode mode)
+{
+    m_triggerOut = mode;
+    return true;
+}
+
+bool DummySignalGenerator::setTriggerIn(TriggerInMode mode)
+{
+    m_triggerIn = mode;
+    return true;
+}
+
+void DummySignalGenerator::attachTriggerLines(TriggerLine *triggerOut, TriggerLine *triggerIn)
+{
+    m_triggerOutLine = triggerOut;
+    m_triggerInLine = triggerIn;
+    std::cout << "[Dummy SG Plugin] Trigger out: " << (triggerOut ? triggerOut->name() : "not connected")
+              << ", trigger in: " << (triggerIn ? triggerIn->name() : "not connected") << std::endl;
+}
+
+void DummySignalGenerator::attachVirtualRange(VirtualRange *range)
+{
+    m_range = range;
+    publishToRange();
+    std::cout << "[Dummy SG Plugin] Virtual range " << (range ? "attached" : "detached") << std::endl;
+}
+
+// The range sees the output state as it is after each change
+void DummySignalGenerator::publishToRange()
+{
+    VirtualRange *range = m_range;
+    if (range != nullptr) {
+        range->setSource(m_rfEnabled, m_freqHz, m_powerDbm);
+    }
+}
+
+// Waits for the trigger edge after seen; false when stopped
+bool DummySignalGenerator::waitForTriggerIn(uint64_t &seen)
+{
+    TriggerLine *line = m_triggerInLine;
+    TriggerEdge edge;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_listMutex);
+            if (m_listStop) {
+                return false;
+            }
+        }
+        if (line == nullptr) {
+            std::unique_lock<std::mutex> lock(m_listMutex);
+            m_listCondition.wait(lock, [&]() { return m_listStop; });
+            return false;
+        }
+        if (line->waitForEdge(seen, TRIGGER_POLL_S, edge)) {
+            seen = edge.sequence;
+            return true;
+        }
+        // Edges lost from the line history are skipped
+        uint64_t count = line->edgeCount();
+        if (count > seen + TriggerLine::HistorySize) {
+            seen = count - 1;
+        }
+    }
+}
+
+// Tunes to a list point; the trigger out pulses once the PLL has locked
+void DummySignalGenerator::tuneListStep(double freqHz)
+{
+    double stepHz = std::fabs(freqHz - m_freqHz);
+    m_freqHz = freqHz;
+    double lockTimeUs = LOCK_TIME_BASE_US + LOCK_TIME_PER_GHZ_US * stepHz / 1e9;
+    std::this_thread::sleep_for(std::chrono::microseconds((long long)lockTimeUs));
+    publishToRange();
+    TriggerLine *out = m_triggerOutLine;
+    if (out != nullptr && m_triggerOut == TriggerOutMode::EveryStep) {
+        out->fire();
+    }
+}
+
+// Steps through the list every dwellS (dwell includes the lock time) or on
+// every trigger edge, for the given number of cycles (0 = until stopped),
+// then returns to the first point
+void DummySignalGenerator::listThread(double dwellS, unsigned int cycles)
+{
+    typedef std::chrono::steady_clock Clock;
+    const auto dwell = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(dwellS));
+    const TriggerInMode triggerIn = m_triggerIn;
+    TriggerLine *inLine = m_triggerInLine;
+    uint64_t seen = inLine ? inLine->edgeCount() : 0;
+    
+    if (triggerIn == TriggerInMode::StartSweep && !waitForTriggerIn(seen)) {
+        return;
+    }
+    
+    auto next = Clock::now();
+    bool completed = true;
+    for (unsigned int cycle = 0; (cycles == 0 || cycle < cycles) && completed; cycle++) {
+        for (size_t i = 0; i < m_freqList.size(); i++) {
+            if (triggerIn == TriggerInMode::EveryStep) {
+                if (!waitForTriggerIn(seen)) {
+                    completed = false;
+                    break;
+                }
+            } else {
+                std::unique_lock<std::mutex> lock(m_listMutex);
+                if (m_listCondition.wait_until(lock, next, [&]() { return m_listStop; })) {
+                    completed = false;
+                    break;
+                }
+                next += dwell;
+            }
+            tuneListStep(m_freqList[i]);
+        }
+        TriggerLine *out = m_triggerOutLine;
+        if (completed && out != nullptr && m_triggerOut == TriggerOutMode::CycleComplete) {
+            out->fire();
+        }
+    }
+    
+    // The last point is held for its dwell as well
+    if (completed && triggerIn != TriggerInMode::EveryStep) {
+        std::unique_lock<std::mutex> lock(m_listMutex);
+        m_listCondition.wait_until(lock, next, [&]() { return m_listStop; });
+    }
+    
+    m_freqHz = m_freqList.front();
+    publishToRange();
+    if (completed) {
+        std::cout << "[Dummy SG Plugin] List sweep completed" << std::endl;
+    }
+}
+
 // Factory functions for plugin loading
 extern "C" {
     #ifdef _WIN32
@@ -265,4 +518,34 @@ extern "C" {
         std::cout << "[Dummy SG Plugin] Factory: Destroying plugin instance" << std::endl;
         delete static_cast<ISignalGeneratorPlugin*>(plugin);
     }
+    
+    // Simulated trigger wiring (see common/triggerbus.h). plugin must be
+    // the instance returned by createSignalGeneratorPlugin, not a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummySGTriggerLines(ISignalGeneratorPlugin* plugin, TriggerLine* triggerOut, TriggerLine* triggerIn)
+    {
+        DummySignalGenerator *generator = dynamic_cast<DummySignalGenerator*>(plugin);
+        if (generator == nullptr) {
+            return false;
+        }
+        generator->attachTriggerLines(triggerOut, triggerIn);
+        return true;
+    }
+    
+    // Simulated antenna range (see common/virtualrange.h). plugin must be
+    // the instance returned by createSignalGeneratorPlugin, not a decorator.
+    #ifdef _WIN32
+        __declspec(dllexport)
+    #endif
+    bool attachDummySGVirtualRange(ISignalGeneratorPlugin* plugin, VirtualRange* range)
+    {
+        DummySignalGenerator *generator = dynamic_cast<DummySignalGenerator*>(plugin);
+        if (generator == nullptr) {
+            return false;
+        }
+        generator->attachVirtualRange(range);
+        return true;
+    }
 }
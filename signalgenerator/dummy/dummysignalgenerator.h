@@ -25,7 +25,13 @@
 #define DUMMYSIGNALGENERATOR_H
 
 #include "iplugininterface.h"
+#include "common/triggerbus.h"
+#include "common/virtualrange.h"
 #include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 class DummySignalGenerator : public ISignalGeneratorPlugin
 {
@@ -46,18 +52,64 @@ public:
     // Configuration
     void setFreq(double freqHz) override;
     void setPower(double powerDbm) override;
+    bool getPower(double &powerDbm) const override;
     
     // RF Control
     void enableRf() override;
     void disableRf() override;
     bool isRfEnabled() const override;
     
+    // Settled mode (simulated PLL lock time)
+    bool setSettledMode(bool enabled, double timeoutMs) override;
+    
+    // Frequency hopping
+    bool loadHopTable(const std::vector<double> &freqsHz) override;
+    bool hopTo(size_t index) override;
+    bool setHopVerification(bool enabled) override;
+    
+    // Simulated list mode and trigger routing
+    bool loadFreqList(const std::vector<double> &freqsHz) override;
+    bool startFreqList(double dwellS, unsigned int cycles) override;
+    bool stopFreqList() override;
+    bool setTriggerOut(TriggerOutMode mode) override;
+    bool setTriggerIn(TriggerInMode mode) override;
+    
+    // Trigger lines of the simulated bench (also exported as
+    // attachDummySGTriggerLines); nullptr disconnects a pin
+    void attachTriggerLines(TriggerLine *triggerOut, TriggerLine *triggerIn);
+    
+    // Simulated range fed by the output (also exported as
+    // attachDummySGVirtualRange); nullptr detaches it
+    void attachVirtualRange(VirtualRange *range);
+    
 private:
+    void listThread(double dwellS, unsigned int cycles);
+    bool waitForTriggerIn(uint64_t &seen);
+    void tuneListStep(double freqHz);
+    void publishToRange();
+    
+
     bool m_isConnected;
-    bool m_rfEnabled;
-    double m_freqHz;
-    double m_powerDbm;
+    std::atomic<bool> m_rfEnabled;
+    std::atomic<double> m_freqHz;
+    std::atomic<double> m_powerDbm;
     std::string m_connectedAddress;
+    bool m_settledMode;
+    std::vector<double> m_hopTable;
+    
+    // List sweep runs on its own thread, paced by the dwell time or the
+    // trigger input
+    std::vector<double> m_freqList;
+    std::thread m_listThread;
+    std::mutex m_listMutex;
+    std::condition_variable m_listCondition;
+    bool m_listStop;
+    TriggerOutMode m_triggerOut;
+    TriggerInMode m_triggerIn;
+    std::atomic<TriggerLine*> m_triggerOutLine;
+    std::atomic<TriggerLine*> m_triggerInLine;
+    
+    std::atomic<VirtualRange*> m_range;
 };
 
 #endif // DUMMYSIGNALGENERATOR_H
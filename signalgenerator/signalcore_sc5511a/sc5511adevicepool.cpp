@@ -0,0 +1,374 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#include "sc5511adevicepool.h"
+#include <iostream>
+#include <cstring>
+
+#ifdef _WIN32
+#include <cfgmgr32.h>
+#include <cwchar>
+#include <cwctype>
+#endif
+
+// parameters to work with the USB device(s)
+#define MAXDEVICES 50
+
+// Enumeration cache lifetime. With hotplug notifications the TTL is only
+// a safety net; without them it bounds how stale a scan can be.
+#define HOTPLUG_CACHE_TTL_MS 30000
+#define POLLED_CACHE_TTL_MS 1000
+
+// How long a released handle stays open for a quick reconnect
+#define IDLE_HANDLE_TIMEOUT_MS 10000
+
+#ifdef _WIN32
+// Device interface paths look like \\?\USB#VID_277C&PID_001E#<serial>#{guid}
+static DWORD CALLBACK hotplugCallback(HCMNOTIFICATION notification, PVOID context,
+                                      CM_NOTIFY_ACTION action, PCM_NOTIFY_EVENT_DATA eventData,
+                                      DWORD eventDataSize)
+{
+    (void)notification;
+    (void)eventDataSize;
+    
+    bool arrived = action == CM_NOTIFY_ACTION_DEVICEINTERFACEARRIVAL;
+    if (!arrived && action != CM_NOTIFY_ACTION_DEVICEINTERFACEREMOVAL) {
+        return ERROR_SUCCESS;
+    }
+    
+    std::wstring link(eventData->u.DeviceInterface.SymbolicLink);
+    for (auto &c : link) {
+        c = (wchar_t)std::towupper(c);
+    }
+    wchar_t ids[32];
+    std::swprintf(ids, 32, L"VID_%04X&PID_%04X", SCI_USB_VID, SCI_USB_PID);
+    size_t idPos = link.find(ids);
+    if (idPos == std::wstring::npos) {
+        return ERROR_SUCCESS;
+    }
+    
+    std::string serial;
+    size_t begin = link.find(L'#', idPos);
+    size_t end = begin == std::wstring::npos ? begin : link.find(L'#', begin + 1);
+    if (end != std::wstring::npos) {
+        for (size_t k = begin + 1; k < end; k++) {
+            serial.push_back((char)link[k]);
+        }
+    }
+    static_cast<SC5511ADevicePool *>(context)->notifyHotplug(serial, arrived);
+    return ERROR_SUCCESS;
+}
+#endif
+
+SC5511ADevicePool &SC5511ADevicePool::instance()
+{
+    static SC5511ADevicePool pool;
+    return pool;
+}
+
+SC5511ADevicePool::SC5511ADevicePool()
+    : m_devicesValid(false)
+    , m_hotplugActive(false)
+    , m_hotplugHandle(NULL)
+    , m_clients(0)
+    , m_reaperStop(false)
+{
+    // One set of serial number buffers for the whole process; the extra
+    // byte keeps 8-character serials terminated
+    m_serialBuffers = (char**)malloc(sizeof(char*)*MAXDEVICES);
+    for (int i = 0; i < MAXDEVICES; i++) {
+        m_serialBuffers[i] = (char*)calloc(SCI_SN_LENGTH + 1, sizeof(char));
+    }
+}
+
+SC5511ADevicePool::~SC5511ADevicePool()
+{
+    // Runs during DLL unload under the loader lock, so nothing here may
+    // wait on another thread. removeClient() already unregistered the
+    // hotplug notification, stopped the reaper and closed idle handles;
+    // a reaper still running here belongs to a leaked plugin instance.
+    if (m_reaper.joinable()) {
+        m_reaper.detach();
+    }
+    
+    for (int i = 0; i < MAXDEVICES; i++) {
+        free(m_serialBuffers[i]);
+    }
+    free(m_serialBuffers);
+}
+
+std::vector<std::string> SC5511ADevicePool::devices(bool forceRescan)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto now = std::chrono::steady_clock::now();
+    auto ttl = std::chrono::milliseconds(m_hotplugActive ? HOTPLUG_CACHE_TTL_MS : POLLED_CACHE_TTL_MS);
+    if (!forceRescan && m_devicesValid && now - m_devicesTime < ttl) {
+        return m_devices;
+    }
+    
+    for (int i = 0; i < MAXDEVICES; i++) {
+        memset(m_serialBuffers[i], 0, SCI_SN_LENGTH + 1);
+    }
+    int count = sc5511a_search_devices(m_serialBuffers);
+    
+    m_devices.clear();
+    for (int i = 0; i < count && i < MAXDEVICES; i++) {
+        m_devices.push_back(std::string(m_serialBuffers[i]));
+    }
+    m_devicesValid = true;
+    m_devicesTime = now;
+    return m_devices;
+}
+
+void SC5511ADevicePool::invalidateDevices()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_devicesValid = false;
+}
+
+sc5511a_device_handle_t SC5511ADevicePool::acquire(const std::string &serial, bool &reused)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    reused = false;
+    
+    auto it = m_entries.find(serial);
+    if (it != m_entries.end()) {
+        if (it->second.inUse) {
+            return NULL;
+        }
+        // One status query confirms the warm handle still talks to the device
+        device_status_t deviceStatus;
+        if (!it->second.stale && sc5511a_get_device_status(it->second.handle, &deviceStatus) == SUCCESS) {
+            it->second.inUse = true;
+            reused = true;
+            return it->second.handle;
+        }
+        sc5511a_close_device(it->second.handle);
+        m_entries.erase(it);
+    }
+    
+    // Need to copy to non-const char* for sc5511a API
+    std::vector<char> serialNumber(serial.begin(), serial.end());
+    serialNumber.push_back('\0');
+    sc5511a_device_handle_t handle = sc5511a_open_device(serialNumber.data());
+    if (handle == NULL) {
+        return NULL;
+    }
+    
+    Entry entry;
+    entry.handle = handle;
+    entry.inUse = true;
+    entry.stale = false;
+    m_entries[serial] = entry;
+    return handle;
+}
+
+void SC5511ADevicePool::release(const std::string &serial)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(serial);
+    if (it == m_entries.end()) {
+        return;
+    }
+    if (it->second.stale) {
+        sc5511a_close_device(it->second.handle);
+        m_entries.erase(it);
+        return;
+    }
+    it->second.inUse = false;
+    it->second.releasedAt = std::chrono::steady_clock::now();
+    
+    if (!m_reaper.joinable()) {
+        m_reaperStop = false;
+        m_reaper = std::thread(&SC5511ADevicePool::reaperLoop, this);
+    }
+    m_reaperCv.notify_all();
+}
+
+void SC5511ADevicePool::discard(const std::string &serial)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(serial);
+    if (it != m_entries.end()) {
+        sc5511a_close_device(it->second.handle);
+        m_entries.erase(it);
+    }
+}
+
+SC5511ADevicePool::ListCache *SC5511ADevicePool::listCache(const std::string &serial)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(serial);
+    return it != m_entries.end() ? &it->second.listCache : NULL;
+}
+
+void SC5511ADevicePool::closeIdle()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!it->second.inUse) {
+            sc5511a_close_device(it->second.handle);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SC5511ADevicePool::addClient()
+{
+    std::lock_guard<std::mutex> clientLock(m_clientMutex);
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        first = m_clients++ == 0;
+    }
+    if (first) {
+        registerHotplug();
+    }
+}
+
+void SC5511ADevicePool::removeClient()
+{
+    std::lock_guard<std::mutex> clientLock(m_clientMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_clients > 0) {
+            return;
+        }
+    }
+    // Unregistering waits for running callbacks, which take m_mutex
+    unregisterHotplug();
+    stopReaper();
+    closeIdle();
+}
+
+void SC5511ADevicePool::reaperLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_reaperStop) {
+        auto now = std::chrono::steady_clock::now();
+        auto timeout = std::chrono::milliseconds(IDLE_HANDLE_TIMEOUT_MS);
+        bool waiting = false;
+        std::chrono::steady_clock::time_point next;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.inUse) {
+                ++it;
+                continue;
+            }
+            auto expiry = it->second.releasedAt + timeout;
+            if (expiry <= now) {
+                std::cout << "[SignalCoreSC5511A Plugin] Closing idle device handle " << it->first << std::endl;
+                sc5511a_close_device(it->second.handle);
+                it = m_entries.erase(it);
+                continue;
+            }
+            if (!waiting || expiry < next) {
+                next = expiry;
+                waiting = true;
+            }
+            ++it;
+        }
+        if (waiting) {
+            m_reaperCv.wait_until(lock, next);
+        } else {
+            m_reaperCv.wait(lock);
+        }
+    }
+}
+
+void SC5511ADevicePool::stopReaper()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reaperStop = true;
+    }
+    m_reaperCv.notify_all();
+    if (m_reaper.joinable()) {
+        m_reaper.join();
+    }
+}
+
+void SC5511ADevicePool::notifyHotplug(const std::string &serial, bool arrived)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_devicesValid = false;
+    
+    if (arrived) {
+        return;
+    }
+    
+    // Removed devices: drop idle handles, flag the ones still in use so
+    // they are closed on release instead of being handed out again
+    auto it = m_entries.find(serial);
+    if (it == m_entries.end()) {
+        return;
+    }
+    if (it->second.inUse) {
+        it->second.stale = true;
+    } else {
+        sc5511a_close_device(it->second.handle);
+        m_entries.erase(it);
+    }
+}
+
+void SC5511ADevicePool::registerHotplug()
+{
+#ifdef _WIN32
+    CM_NOTIFY_FILTER filter;
+    memset(&filter, 0, sizeof(filter));
+    filter.cbSize = sizeof(filter);
+    filter.Flags = CM_NOTIFY_FILTER_FLAG_ALL_INTERFACE_CLASSES;
+    filter.FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINTERFACE;
+    
+    HCMNOTIFICATION notification = NULL;
+    if (CM_Register_Notification(&filter, this, hotplugCallback, &notification) == CR_SUCCESS) {
+        // Events while no notification was registered went unseen
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hotplugHandle = notification;
+        m_hotplugActive = true;
+        m_devicesValid = false;
+    } else {
+        std::cerr << "[SignalCoreSC5511A Plugin] USB hotplug notifications unavailable, "
+                  << "device scans are cached for " << POLLED_CACHE_TTL_MS << " ms" << std::endl;
+    }
+#endif
+}
+
+void SC5511ADevicePool::unregisterHotplug()
+{
+#ifdef _WIN32
+    HCMNOTIFICATION notification;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hotplugActive) {
+            return;
+        }
+        notification = (HCMNOTIFICATION)m_hotplugHandle;
+        m_hotplugActive = false;
+        m_hotplugHandle = NULL;
+    }
+    CM_Unregister_Notification(notification);
+#endif
+}
@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2025 PT Fusi Global Teknologi. All rights reserved.
+** Coded by: Yan Syafri Hidayat
+**
+** This file is part of the Antenna Tester GUI plugin interface.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+****************************************************************************/
+
+#ifndef SC5511ADEVICEPOOL_H
+#define SC5511ADEVICEPOOL_H
+
+#include <Windows.h>  // Required for HANDLE type used by sc5511a.h
+#include "sc5511a.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Process-wide pool of SC5511A USB handles and enumeration results.
+//
+// Handles released by a plugin instance stay open for a short idle time
+// so a later connect to the same serial number (from any instance) skips
+// sc5511a_open_device. After that, or when the last plugin instance is
+// destroyed, they are closed so other processes can open the device.
+// The enumeration is cached until a USB hotplug event for the product
+// invalidates it, or until the cache TTL expires when hotplug
+// notifications are not available.
+class SC5511ADevicePool
+{
+public:
+    // What the plugin knows about the device's list buffers, identified
+    // by list fingerprints (0 = unknown). Kept with the handle so it
+    // survives reconnects; dropped when the handle is closed.
+    struct ListCache {
+        uint64_t ramHash;
+        size_t ramPoints;
+        uint64_t eepromHash;
+        size_t eepromPoints;
+        std::map<uint64_t, unsigned> requests;  // loads per fingerprint
+        
+        ListCache() : ramHash(0), ramPoints(0), eepromHash(0), eepromPoints(0) {}
+    };
+    
+    static SC5511ADevicePool &instance();
+    
+    // Serial numbers of attached devices, from the cache when it is valid
+    std::vector<std::string> devices(bool forceRescan);
+    void invalidateDevices();
+    
+    // Returns an open handle for the serial number, or NULL if the device
+    // cannot be opened or is already in use. reused is set when a warm
+    // handle was handed out.
+    sc5511a_device_handle_t acquire(const std::string &serial, bool &reused);
+    // Keeps the handle open for the next acquire()
+    void release(const std::string &serial);
+    // Closes the handle instead of keeping it, e.g. after a USB error
+    void discard(const std::string &serial);
+    // List cache of an acquired device, NULL if the serial is not open.
+    // Only the instance holding the handle may use it.
+    ListCache *listCache(const std::string &serial);
+    
+    // Closes all idle handles
+    void closeIdle();
+    
+    // Plugin instances register themselves. The first one registers the
+    // hotplug notification; when the last one goes away it is unregistered,
+    // the reaper stops and the idle handles are closed.
+    void addClient();
+    void removeClient();
+    
+    // Called from the hotplug notification thread
+    void notifyHotplug(const std::string &serial, bool arrived);
+    
+private:
+    struct Entry {
+        sc5511a_device_handle_t handle;
+        bool inUse;
+        bool stale;     // device was unplugged while the handle was open
+        std::chrono::steady_clock::time_point releasedAt;
+        ListCache listCache;
+    };
+    
+    SC5511ADevicePool();
+    ~SC5511ADevicePool();
+    SC5511ADevicePool(const SC5511ADevicePool &) = delete;
+    SC5511ADevicePool &operator=(const SC5511ADevicePool &) = delete;
+    
+    void registerHotplug();
+    void unregisterHotplug();
+    
+    // Closes handles that stayed idle for longer than the idle timeout
+    void reaperLoop();
+    void stopReaper();
+    
+    std::mutex m_mutex;
+    std::map<std::string, Entry> m_entries;
+    
+    char **m_serialBuffers;
+    std::vector<std::string> m_devices;
+    bool m_devicesValid;
+    std::chrono::steady_clock::time_point m_devicesTime;
+    
+    bool m_hotplugActive;
+    void *m_hotplugHandle;
+    
+    std::mutex m_clientMutex;  // serializes addClient() / removeClient()
+    int m_clients;
+    std::thread m_reaper;
+    std::condition_variable m_reaperCv;
+    bool m_reaperStop;
+};
+
+#endif // SC5511ADEVICEPOOL_H
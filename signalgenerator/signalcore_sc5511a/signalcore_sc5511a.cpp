@@ -26,8 +26,56 @@
 #include <thread>
 #include <chrono>
 
-// parameters to work with the USB device(s)
-#define MAXDEVICES 50
+// temperature read interval while RF1 is in standby (one USB query each)
+#define TEMPERATURE_SAMPLE_INTERVAL_S 5
+
+// PLL lock polling in settled mode: the first poll waits for a fraction
+// of the typical lock time, then the interval doubles up to the cap
+#define LOCK_POLL_INITIAL_US 20
+#define LOCK_POLL_MAX_US 1000
+#define LOCK_FIRST_POLL_FRACTION 0.8
+#define DEFAULT_SETTLE_TIMEOUT_MS 50.0
+
+// Channel ranges: RF1 per sc5511a_set_freq, RF2 in 25 MHz steps
+#define RF1_MIN_FREQ_HZ 100.0e6
+#define RF1_MAX_FREQ_HZ 20.0e9
+#define RF2_MIN_FREQ_MHZ 25
+#define RF2_MAX_FREQ_MHZ 3000
+#define RF2_STEP_MHZ 25
+
+// List mode: RAM buffer size and dwell time unit (500 us)
+#define LIST_MAX_POINTS 2048
+#define LIST_DWELL_UNIT_S 500e-6
+#define LIST_TERMINATOR 0xFFFFFFFFFFULL
+#define LIST_FINGERPRINT_HISTORY 256
+
+// Standby: RF1 needs about a second to restabilize after standby (per the
+// sc5511a_set_standby docs) until a wake-up has been measured. Gaps
+// shorter than STANDBY_MIN_IDLE_FACTOR wake lead times are not worth it.
+#define STANDBY_DEFAULT_WAKE_LEAD_S 1.0
+#define STANDBY_LEAD_MARGIN 1.25
+#define STANDBY_MIN_IDLE_FACTOR 2.0
+#define STANDBY_WAKE_TIMEOUT_S 3.0
+
+// Frequency word in Hz as the device takes it; setFreq(), the hop table
+// and the list all truncate the same way so they land on the same word
+static unsigned long long freqWord(double freqHz)
+{
+    return (unsigned long long)freqHz;
+}
+
+// FNV-1a list fingerprint
+static uint64_t listFingerprint(const std::vector<unsigned long long> &words)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned long long word : words) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash ^= (word >> (byte * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash ? hash : 1;
+}
 
 SignalCoreSC5511A::SignalCoreSC5511A()
     : m_isConnected(false)
@@ -35,15 +83,23 @@ SignalCoreSC5511A::SignalCoreSC5511A()
     , m_freqHz(5510.0e6)  // 5510 MHz default
     , m_powerDbm(0.0)     // 0 dBm default
     , m_connectedAddress("")
+    , m_rf2Enabled(false)
+    , m_rf2FreqHz(1000.0e6)
     , dev_handle(NULL)
     , num_of_devices(0)
     , status(0)
+    , m_deviceError(false)
+    , m_settledMode(false)
+    , m_settleTimeoutMs(DEFAULT_SETTLE_TIMEOUT_MS)
+    , m_typicalLockUs(0.0)
+    , m_hopVerify(false)
+    , m_triggerOut(TriggerOutMode::Off)
+    , m_triggerIn(TriggerInMode::Software)
+    , m_powerThreadStop(false)
+    , m_inStandby(false)
+    , m_wakeLeadS(STANDBY_DEFAULT_WAKE_LEAD_S)
 {
-    // Allocate memory for device list
-    device_list = (char**)malloc(sizeof(char*)*MAXDEVICES);
-    for (int i=0; i<MAXDEVICES; i++)
-        device_list[i] = (char*)malloc(sizeof(char)*SCI_SN_LENGTH);
-    
+    SC5511ADevicePool::instance().addClient();
     std::cout << "[SignalCoreSC5511A Plugin] Instance created" << std::endl;
 }
 
@@ -53,25 +109,26 @@ std::vector<DeviceInfo> SignalCoreSC5511A::scanDevices()
     
     std::vector<DeviceInfo> devices;
     
-    // Search for devices using sc5511a API
-    num_of_devices = sc5511a_search_devices(device_list);
+    // Enumeration is cached process-wide and invalidated on USB hotplug
+    std::vector<std::string> serials = SC5511ADevicePool::instance().devices(false);
+    num_of_devices = (int)serials.size();
     
     if (num_of_devices == 0) {
         std::cout << "[SignalCoreSC5511A Plugin] No signal core devices found" << std::endl;
     } else {
         std::cout << "[SignalCoreSC5511A Plugin] There are " << num_of_devices << " SignalCore " << SCI_PRODUCT_NAME << " USB devices found." << std::endl;
         
-        // Convert device_list to DeviceInfo vector
+        // Convert serial numbers to DeviceInfo vector
         for (int i = 0; i < num_of_devices; i++) {
             DeviceInfo device;
             device.name = std::string(SCI_PRODUCT_NAME);
-            device.serialNumber = std::string(device_list[i]);
-            device.address = std::string(device_list[i]); // Use serial number as address
+            device.serialNumber = serials[i];
+            device.address = serials[i]; // Use serial number as address
             device.type = "USB";
             device.isAvailable = true;
             devices.push_back(device);
             
-            std::cout << "  Device " << (i+1) << " has Serial Number: " << device_list[i] << std::endl;
+            std::cout << "  Device " << (i+1) << " has Serial Number: " << serials[i] << std::endl;
         }
     }
     
@@ -90,29 +147,47 @@ bool SignalCoreSC5511A::connectToDevice(const std::string &address)
     
     std::cout << "[SignalCoreSC5511A Plugin] Connecting to device at: " << address << std::endl;
     
-    // Open the device using serial number (address)
-    // Need to copy to non-const char* for sc5511a API
-    char* serial_number = new char[address.length() + 1];
-    strcpy(serial_number, address.c_str());
-    
-    dev_handle = sc5511a_open_device(serial_number);
-    delete[] serial_number;
+    // Open the device using serial number (address); handles released
+    // by an earlier connection are reused from the process-wide pool
+    bool reused = false;
+    dev_handle = SC5511ADevicePool::instance().acquire(address, reused);
     
     if (dev_handle == NULL) {
         std::cerr << "[SignalCoreSC5511A Plugin] Device with serial number: " << address << " cannot be opened." << std::endl;
-        std::cerr << "[SignalCoreSC5511A Plugin] Please ensure your device is powered on and connected" << std::endl;
+        std::cerr << "[SignalCoreSC5511A Plugin] Please ensure your device is powered on, connected and not in use" << std::endl;
         if (onError) {
             onError("Cannot open device: " + address);
         }
         return false;
     }
     
+    if (reused) {
+        std::cout << "[SignalCoreSC5511A Plugin] Reusing open device handle" << std::endl;
+    }
+    
     m_connectedAddress = address;
     m_isConnected = true;
+    m_deviceError = false;
+    
+    // Publish the device temperature as a health metric
+    m_temperatureGauge = MetricsSegment::global().gauge("antenna_generator_temperature_celsius",
+        metricLabel("instrument", SCI_PRODUCT_NAME) + "," + metricLabel("serial", address),
+        "SC5511A internal temperature");
+    sampleTemperature();
+    m_lockTimeGauge = MetricsSegment::global().gauge("antenna_generator_lock_time_microseconds",
+        metricLabel("instrument", SCI_PRODUCT_NAME) + "," + metricLabel("serial", address),
+        "SC5511A PLL lock time of the last settled frequency change");
+    m_standbyGauge = MetricsSegment::global().gauge("antenna_generator_standby",
+        metricLabel("instrument", SCI_PRODUCT_NAME) + "," + metricLabel("serial", address),
+        "SC5511A RF1 standby state (1 = standby)");
+    m_lockTimeoutCounter = MetricsSegment::global().counter("antenna_generator_lock_timeouts_total",
+        metricLabel("instrument", SCI_PRODUCT_NAME) + "," + metricLabel("serial", address),
+        "Settled frequency changes that did not lock in time");
     
     // Disable Sweep/List Mode (set to single tone mode)
     status = sc5511a_set_rf_mode(dev_handle, 0);
     if (status != SUCCESS) {
+        noteDeviceError(status);
         std::cerr << "[SignalCoreSC5511A Plugin] Failed to set RF mode" << std::endl;
     }
     
@@ -132,16 +207,9 @@ SignalCoreSC5511A::~SignalCoreSC5511A()
         disconnect();
     }
     
-    // Free device list memory
-    if (device_list != NULL) {
-        for (int i = 0; i < MAXDEVICES; i++) {
-            if (device_list[i] != NULL) {
-                free(device_list[i]);
-            }
-        }
-        free(device_list);
-    }
-    
+    // The last instance closes the pooled handles so the device is free
+    // for other processes
+    SC5511ADevicePool::instance().removeClient();
     std::cout << "[SignalCoreSC5511A Plugin] Instance destroyed" << std::endl;
 }
 
@@ -178,16 +246,33 @@ void SignalCoreSC5511A::disconnect()
         return;
     }
     
+    // Leave the device powered for the next session
+    stopPowerThread();
+    m_powerError.clear();
+    if (m_inStandby && dev_handle != NULL) {
+        sc5511a_set_standby(dev_handle, 0);
+        m_inStandby = false;
+        m_standbyGauge.set(0.0);
+    }
+    
     // Turn off RF before disconnecting
     if (m_rfEnabled) {
         disableRf();
     }
+    if (m_rf2Enabled) {
+        setChannelRfEnabled(1, false);
+    }
     
     std::cout << "[SignalCoreSC5511A Plugin] Disconnecting from " << m_connectedAddress << std::endl;
     
-    // Close the device using sc5511a API
+    // Return the handle to the pool so a reconnect skips the USB open,
+    // unless the USB link failed during the session
     if (dev_handle != NULL) {
-        sc5511a_close_device(dev_handle);
+        if (m_deviceError) {
+            SC5511ADevicePool::instance().discard(m_connectedAddress);
+        } else {
+            SC5511ADevicePool::instance().release(m_connectedAddress);
+        }
         dev_handle = NULL;
     }
     
@@ -210,15 +295,25 @@ void SignalCoreSC5511A::setFreq(double freqHz)
     m_freqHz = freqHz;
     
     if (m_isConnected && dev_handle != NULL) {
-        unsigned long long int rf_freq = (unsigned long long int)freqHz;
+        ensureAwake();
+        unsigned long long int rf_freq = freqWord(freqHz);
+        auto start = std::chrono::steady_clock::now();
         status = sc5511a_set_freq(dev_handle, rf_freq);
         if (status != SUCCESS) {
+            noteDeviceError(status);
             std::cerr << "[SignalCoreSC5511A Plugin] Failed to set frequency" << std::endl;
             if (onError) {
                 onError("Failed to set frequency");
             }
         } else {
             std::cout << "[SignalCoreSC5511A Plugin] Frequency set to " << freqHz / 1e6 << " MHz" << std::endl;
+            
+            double lockTimeUs = 0.0;
+            if (m_settledMode && waitForLock(start, lockTimeUs)) {
+                if (onFreqSettled) {
+                    onFreqSettled(freqHz, lockTimeUs);
+                }
+            }
         }
     } else {
         std::cout << "[SignalCoreSC5511A Plugin] Frequency cached (not connected): " << freqHz / 1e6 << " MHz" << std::endl;
@@ -230,9 +325,11 @@ void SignalCoreSC5511A::setPower(double powerDbm)
     m_powerDbm = powerDbm;
     
     if (m_isConnected && dev_handle != NULL) {
+        ensureAwake();
         float rf_level = (float)powerDbm;
         status = sc5511a_set_level(dev_handle, rf_level);
         if (status != SUCCESS) {
+            noteDeviceError(status);
             std::cerr << "[SignalCoreSC5511A Plugin] Failed to set power level" << std::endl;
             if (onError) {
                 onError("Failed to set power level");
@@ -245,6 +342,13 @@ void SignalCoreSC5511A::setPower(double powerDbm)
     }
 }
 
+// The cached level, also before connect
+bool SignalCoreSC5511A::getPower(double &powerDbm) const
+{
+    powerDbm = m_powerDbm;
+    return true;
+}
+
 void SignalCoreSC5511A::enableRf()
 {
     if (!m_isConnected) {
@@ -259,6 +363,7 @@ void SignalCoreSC5511A::enableRf()
         std::cout << "[SignalCoreSC5511A Plugin] RF already enabled" << std::endl;
         return;
     }
+    ensureAwake();
     
     std::cout << "[SignalCoreSC5511A Plugin] Enabling RF output..." << std::endl;
     std::cout << "  Frequency: " << m_freqHz / 1e6 << " MHz" << std::endl;
@@ -268,6 +373,7 @@ void SignalCoreSC5511A::enableRf()
     if (dev_handle != NULL) {
         status = sc5511a_set_output(dev_handle, 1);
         if (status != SUCCESS) {
+            noteDeviceError(status);
             std::cerr << "[SignalCoreSC5511A Plugin] Failed to enable RF output" << std::endl;
             if (onError) {
                 onError("Failed to enable RF output");
@@ -295,6 +401,7 @@ void SignalCoreSC5511A::disableRf()
         std::cout << "[SignalCoreSC5511A Plugin] RF already disabled" << std::endl;
         return;
     }
+    ensureAwake();
     
     std::cout << "[SignalCoreSC5511A Plugin] Disabling RF output..." << std::endl;
     
@@ -302,6 +409,7 @@ void SignalCoreSC5511A::disableRf()
     if (dev_handle != NULL) {
         status = sc5511a_set_output(dev_handle, 0);
         if (status != SUCCESS) {
+            noteDeviceError(status);
             std::cerr << "[SignalCoreSC5511A Plugin] Failed to disable RF output" << std::endl;
         }
     }
@@ -319,6 +427,675 @@ bool SignalCoreSC5511A::isRfEnabled() const
     return m_rfEnabled;
 }
 
+// Only called on connect and while RF1 is idle (standby entry, the power
+// thread), so the extra USB query never delays a setFreq()/setPower()
+void SignalCoreSC5511A::sampleTemperature()
+{
+    if (!m_isConnected || dev_handle == NULL || !m_temperatureGauge.isValid()) {
+        return;
+    }
+    
+    m_lastTemperatureSample = std::chrono::steady_clock::now();
+    
+    float temperature = 0.0f;
+    if (sc5511a_get_temperature(dev_handle, &temperature) == SUCCESS) {
+        m_temperatureGauge.set(temperature);
+    } else {
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to read temperature" << std::endl;
+    }
+}
+
+// Transfer-level failures leave the handle in an unknown state, so it is
+// closed on disconnect instead of being kept warm for the next connect
+void SignalCoreSC5511A::noteDeviceError(int result)
+{
+    if (result == USBDEVICEERROR || result == USBTRANSFERERROR || result == COMMERROR) {
+        m_deviceError = true;
+    }
+}
+
+int SignalCoreSC5511A::channelCount() const
+{
+    return 2;
+}
+
+bool SignalCoreSC5511A::channelInfo(int channel, ChannelInfo &info) const
+{
+    if (channel == 0) {
+        info.name = "RF1";
+        info.minFreqHz = RF1_MIN_FREQ_HZ;
+        info.maxFreqHz = RF1_MAX_FREQ_HZ;
+        info.freqResolutionHz = 1.0;
+        info.hasPowerControl = true;
+        info.hasOutputControl = true;
+        return true;
+    }
+    if (channel == 1) {
+        info.name = "RF2";
+        info.minFreqHz = RF2_MIN_FREQ_MHZ * 1e6;
+        info.maxFreqHz = RF2_MAX_FREQ_MHZ * 1e6;
+        info.freqResolutionHz = RF2_STEP_MHZ * 1e6;
+        info.hasPowerControl = false;
+        info.hasOutputControl = true;
+        return true;
+    }
+    return false;
+}
+
+bool SignalCoreSC5511A::setChannelFreq(int channel, double freqHz)
+{
+    if (channel == 0) {
+        setFreq(freqHz);
+        return true;
+    }
+    if (channel != 1) {
+        return false;
+    }
+    
+    // RF2 only tunes in 25 MHz steps
+    int steps = (int)(freqHz / (RF2_STEP_MHZ * 1e6) + 0.5);
+    int freqMHz = steps * RF2_STEP_MHZ;
+    if (freqMHz < RF2_MIN_FREQ_MHZ || freqMHz > RF2_MAX_FREQ_MHZ) {
+        std::cerr << "[SignalCoreSC5511A Plugin] RF2 frequency out of range: " << freqHz / 1e6 << " MHz" << std::endl;
+        if (onError) {
+            onError("RF2 frequency out of range");
+        }
+        return false;
+    }
+    m_rf2FreqHz = freqMHz * 1e6;
+    
+    if (m_isConnected && dev_handle != NULL) {
+        ensureAwake();
+        status = sc5511a_set_rf2_freq(dev_handle, (unsigned short)freqMHz);
+        if (status != SUCCESS) {
+            noteDeviceError(status);
+            std::cerr << "[SignalCoreSC5511A Plugin] Failed to set RF2 frequency" << std::endl;
+            if (onError) {
+                onError("Failed to set RF2 frequency");
+            }
+            return false;
+        }
+        std::cout << "[SignalCoreSC5511A Plugin] RF2 frequency set to " << freqMHz << " MHz" << std::endl;
+    } else {
+        std::cout << "[SignalCoreSC5511A Plugin] RF2 frequency cached (not connected): " << freqMHz << " MHz" << std::endl;
+    }
+    return true;
+}
+
+bool SignalCoreSC5511A::setChannelPower(int channel, double powerDbm)
+{
+    if (channel != 0) {
+        // RF2 has a fixed output level
+        return false;
+    }
+    setPower(powerDbm);
+    return true;
+}
+
+bool SignalCoreSC5511A::setChannelRfEnabled(int channel, bool enabled)
+{
+    if (channel == 0) {
+        if (enabled) {
+            enableRf();
+        } else {
+            disableRf();
+        }
+        return m_rfEnabled == enabled;
+    }
+    if (channel != 1) {
+        return false;
+    }
+    
+    if (!m_isConnected || dev_handle == NULL) {
+        std::cerr << "[SignalCoreSC5511A Plugin] Cannot switch RF2 - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Generator not connected");
+        }
+        return false;
+    }
+    
+    ensureAwake();
+    
+    // RF2 is switched through its standby control; program the cached
+    // frequency first so the output comes up where it was set
+    status = SUCCESS;
+    if (enabled) {
+        status = sc5511a_set_rf2_freq(dev_handle, (unsigned short)(m_rf2FreqHz / 1e6 + 0.5));
+    }
+    if (status == SUCCESS) {
+        status = sc5511a_set_rf2_standby(dev_handle, enabled ? 0 : 1);
+    }
+    if (status != SUCCESS) {
+        noteDeviceError(status);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to " << (enabled ? "enable" : "disable") << " RF2 output" << std::endl;
+        if (onError) {
+            onError(enabled ? "Failed to enable RF2 output" : "Failed to disable RF2 output");
+        }
+        return false;
+    }
+    
+    m_rf2Enabled = enabled;
+    std::cout << "[SignalCoreSC5511A Plugin] RF2 output " << (enabled ? "ENABLED" : "DISABLED") << std::endl;
+    return true;
+}
+
+bool SignalCoreSC5511A::isChannelRfEnabled(int channel) const
+{
+    if (channel == 0) {
+        return m_rfEnabled;
+    }
+    return channel == 1 && m_rf2Enabled;
+}
+
+bool SignalCoreSC5511A::loadHopTable(const std::vector<double> &freqsHz)
+{
+    std::vector<unsigned long long> words;
+    words.reserve(freqsHz.size());
+    for (double freqHz : freqsHz) {
+        if (freqHz < RF1_MIN_FREQ_HZ || freqHz > RF1_MAX_FREQ_HZ) {
+            std::cerr << "[SignalCoreSC5511A Plugin] Hop frequency out of range: " << freqHz / 1e6 << " MHz" << std::endl;
+            if (onError) {
+                onError("Hop frequency out of range");
+            }
+            return false;
+        }
+        // RF_FREQUENCY takes the frequency in Hz, the same word setFreq()
+        // passes to sc5511a_set_freq
+        words.push_back(freqWord(freqHz));
+    }
+    
+    m_hopWords.swap(words);
+    std::cout << "[SignalCoreSC5511A Plugin] Hop table loaded (" << m_hopWords.size() << " frequencies)" << std::endl;
+    return true;
+}
+
+// Hot path: setFreq() without the console output, which dominates its
+// host-side cost. No logging unless something fails.
+bool SignalCoreSC5511A::hopTo(size_t index)
+{
+    if (index >= m_hopWords.size() || !m_isConnected || dev_handle == NULL) {
+        return false;
+    }
+    ensureAwake();
+    
+    auto start = std::chrono::steady_clock::now();
+    unsigned long long word = m_hopWords[index];
+    status = sc5511a_reg_write(dev_handle, RF_FREQUENCY, word);
+    if (status != SUCCESS) {
+        noteDeviceError(status);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to hop to " << word / 1e6 << " MHz" << std::endl;
+        if (onError) {
+            onError("Failed to set frequency");
+        }
+        return false;
+    }
+    m_freqHz = (double)word;
+    
+    if (m_hopVerify) {
+        device_rf_params_t rfParams = {};
+        if (sc5511a_get_rf_parameters(dev_handle, &rfParams) != SUCCESS || rfParams.rf1_freq != word) {
+            std::cerr << "[SignalCoreSC5511A Plugin] Hop verification failed at entry " << index
+                      << ": expected " << word << " Hz, device reports " << rfParams.rf1_freq << " Hz" << std::endl;
+            if (onError) {
+                onError("Hop verification failed");
+            }
+            return false;
+        }
+    }
+    
+    double lockTimeUs = 0.0;
+    if (m_settledMode && waitForLock(start, lockTimeUs)) {
+        if (onFreqSettled) {
+            onFreqSettled(m_freqHz, lockTimeUs);
+        }
+    }
+    return true;
+}
+
+bool SignalCoreSC5511A::setHopVerification(bool enabled)
+{
+    m_hopVerify = enabled;
+    std::cout << "[SignalCoreSC5511A Plugin] Hop verification " << (enabled ? "enabled" : "disabled") << std::endl;
+    return true;
+}
+
+// Unchanged lists are never re-sent: a list already in RAM is only
+// spot-checked, a list stored in EEPROM is swapped in with one transfer.
+// A list that keeps coming back is moved into EEPROM once it has been
+// requested more often than the list currently stored there.
+bool SignalCoreSC5511A::loadFreqList(const std::vector<double> &freqsHz)
+{
+    if (!m_isConnected || dev_handle == NULL) {
+        std::cerr << "[SignalCoreSC5511A Plugin] Cannot load list - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Generator not connected");
+        }
+        return false;
+    }
+    if (freqsHz.empty() || freqsHz.size() > LIST_MAX_POINTS) {
+        std::cerr << "[SignalCoreSC5511A Plugin] List must have 1 to " << LIST_MAX_POINTS << " points" << std::endl;
+        if (onError) {
+            onError("Invalid frequency list length");
+        }
+        return false;
+    }
+    ensureAwake();
+    
+    std::vector<unsigned long long> words;
+    words.reserve(freqsHz.size());
+    for (double freqHz : freqsHz) {
+        if (freqHz < RF1_MIN_FREQ_HZ || freqHz > RF1_MAX_FREQ_HZ) {
+            std::cerr << "[SignalCoreSC5511A Plugin] List frequency out of range: " << freqHz / 1e6 << " MHz" << std::endl;
+            if (onError) {
+                onError("List frequency out of range");
+            }
+            return false;
+        }
+        words.push_back(freqWord(freqHz));
+    }
+    
+    SC5511ADevicePool::ListCache *cache = SC5511ADevicePool::instance().listCache(m_connectedAddress);
+    SC5511ADevicePool::ListCache fallback;
+    if (cache == NULL) {
+        cache = &fallback;
+    }
+    uint64_t hash = listFingerprint(words);
+    if (cache->requests.size() > LIST_FINGERPRINT_HISTORY) {
+        cache->requests.clear();
+    }
+    unsigned int requests = ++cache->requests[hash];
+    
+    if (cache->ramHash == hash && cache->ramPoints == words.size() && verifyList(words)) {
+        std::cout << "[SignalCoreSC5511A Plugin] List already in RAM (" << words.size() << " points)" << std::endl;
+        return true;
+    }
+    
+    cache->ramHash = 0;
+    if (cache->eepromHash == hash && cache->eepromPoints == words.size()) {
+        if (sc5511a_list_buffer_transfer(dev_handle, 1) == SUCCESS
+            && sc5511a_list_buffer_points(dev_handle, (unsigned int)words.size()) == SUCCESS
+            && verifyList(words)) {
+            cache->ramHash = hash;
+            cache->ramPoints = words.size();
+            std::cout << "[SignalCoreSC5511A Plugin] List restored from EEPROM (" << words.size() << " points)" << std::endl;
+            return true;
+        }
+        cache->eepromHash = 0;
+    }
+    
+    if (!uploadList(words) || !verifyList(words)) {
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to load frequency list" << std::endl;
+        if (onError) {
+            onError("Failed to load frequency list");
+        }
+        return false;
+    }
+    cache->ramHash = hash;
+    cache->ramPoints = words.size();
+    std::cout << "[SignalCoreSC5511A Plugin] List uploaded (" << words.size() << " points)" << std::endl;
+    
+    unsigned int eepromRequests = cache->eepromHash ? cache->requests[cache->eepromHash] : 0;
+    if (requests > 1 && requests > eepromRequests && cache->eepromHash != hash) {
+        if (sc5511a_list_buffer_transfer(dev_handle, 0) == SUCCESS) {
+            cache->eepromHash = hash;
+            cache->eepromPoints = words.size();
+            std::cout << "[SignalCoreSC5511A Plugin] List stored in EEPROM" << std::endl;
+        } else {
+            cache->eepromHash = 0;
+            std::cerr << "[SignalCoreSC5511A Plugin] Failed to store list in EEPROM" << std::endl;
+        }
+    }
+    return true;
+}
+
+bool SignalCoreSC5511A::uploadList(const std::vector<unsigned long long> &words)
+{
+    // Index reset, one write per point, then the terminator sets the count
+    if (sc5511a_list_buffer_write(dev_handle, 0) != SUCCESS) {
+        return false;
+    }
+    for (unsigned long long word : words) {
+        if (sc5511a_list_buffer_write(dev_handle, word) != SUCCESS) {
+            return false;
+        }
+    }
+    return sc5511a_list_buffer_write(dev_handle, LIST_TERMINATOR) == SUCCESS;
+}
+
+// Spot check: point count plus first, middle and last entry
+bool SignalCoreSC5511A::verifyList(const std::vector<unsigned long long> &words)
+{
+    device_rf_params_t rfParams = {};
+    if (sc5511a_get_rf_parameters(dev_handle, &rfParams) != SUCCESS || rfParams.buffer_points != words.size()) {
+        return false;
+    }
+    
+    size_t samples[3] = { 0, words.size() / 2, words.size() - 1 };
+    for (size_t index : samples) {
+        unsigned long long freq = 0;
+        if (sc5511a_list_buffer_read(dev_handle, (unsigned int)index, &freq) != SUCCESS || freq != words[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SignalCoreSC5511A::startFreqList(double dwellS, unsigned int cycles)
+{
+    if (!m_isConnected || dev_handle == NULL) {
+        std::cerr << "[SignalCoreSC5511A Plugin] Cannot start list - not connected" << std::endl;
+        if (onError) {
+            onError("Signal Generator not connected");
+        }
+        return false;
+    }
+    ensureAwake();
+    
+    // List from buffer, start to end. A hardware trigger either starts the
+    // sweep or steps it; otherwise a soft trigger starts it below.
+    list_mode_t listMode = {};
+    listMode.sss_mode = 0;
+    listMode.return_to_start = 1;
+    listMode.hw_trigger = (m_triggerIn != TriggerInMode::Software) ? 1 : 0;
+    listMode.step_on_hw_trig = (m_triggerIn == TriggerInMode::EveryStep) ? 1 : 0;
+    listMode.trig_out_enable = (m_triggerOut != TriggerOutMode::Off) ? 1 : 0;
+    listMode.trig_out_on_cycle = (m_triggerOut == TriggerOutMode::CycleComplete) ? 1 : 0;
+    
+    unsigned int dwellUnits = (unsigned int)(dwellS / LIST_DWELL_UNIT_S + 0.5);
+    if (dwellUnits < 1) {
+        dwellUnits = 1;
+    }
+    
+    status = sc5511a_list_mode_config(dev_handle, &listMode);
+    if (status == SUCCESS) status = sc5511a_list_dwell_time(dev_handle, dwellUnits);
+    if (status == SUCCESS) status = sc5511a_list_cycle_count(dev_handle, cycles);
+    if (status == SUCCESS) status = sc5511a_set_rf_mode(dev_handle, 1);
+    if (status == SUCCESS && !listMode.hw_trigger) status = sc5511a_list_soft_trigger(dev_handle);
+    if (status != SUCCESS) {
+        noteDeviceError(status);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to start list sweep" << std::endl;
+        if (onError) {
+            onError("Failed to start list sweep");
+        }
+        return false;
+    }
+    
+    if (listMode.hw_trigger) {
+        std::cout << "[SignalCoreSC5511A Plugin] List sweep armed, waiting for "
+                  << (listMode.step_on_hw_trig ? "a trigger per step" : "a start trigger") << std::endl;
+    } else {
+        std::cout << "[SignalCoreSC5511A Plugin] List sweep started (dwell " << dwellUnits * LIST_DWELL_UNIT_S * 1e3
+                  << " ms, " << cycles << " cycles)" << std::endl;
+    }
+    return true;
+}
+
+bool SignalCoreSC5511A::setTriggerOut(TriggerOutMode mode)
+{
+    m_triggerOut = mode;
+    std::cout << "[SignalCoreSC5511A Plugin] Trigger out: "
+              << (mode == TriggerOutMode::Off ? "off" : mode == TriggerOutMode::EveryStep ? "every step" : "cycle complete")
+              << std::endl;
+    return true;
+}
+
+bool SignalCoreSC5511A::setTriggerIn(TriggerInMode mode)
+{
+    m_triggerIn = mode;
+    std::cout << "[SignalCoreSC5511A Plugin] Trigger in: "
+              << (mode == TriggerInMode::Software ? "software" : mode == TriggerInMode::StartSweep ? "start sweep" : "every step")
+              << std::endl;
+    return true;
+}
+
+bool SignalCoreSC5511A::stopFreqList()
+{
+    if (!m_isConnected || dev_handle == NULL) {
+        return false;
+    }
+    
+    ensureAwake();
+    
+    // Back to single tone mode at the last set frequency
+    status = sc5511a_set_rf_mode(dev_handle, 0);
+    if (status != SUCCESS) {
+        noteDeviceError(status);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to stop list sweep" << std::endl;
+        if (onError) {
+            onError("Failed to stop list sweep");
+        }
+        return false;
+    }
+    std::cout << "[SignalCoreSC5511A Plugin] List sweep stopped" << std::endl;
+    return true;
+}
+
+bool SignalCoreSC5511A::announceIdle(double idleS)
+{
+    if (!m_isConnected || dev_handle == NULL) {
+        return false;
+    }
+    
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_powerMutex);
+        error.swap(m_powerError);
+        announceIdleLocked(idleS);
+    }
+    if (!error.empty() && onError) {
+        onError(error);
+    }
+    return true;
+}
+
+void SignalCoreSC5511A::announceIdleLocked(double idleS)
+{
+    // Wake early enough to be stable when the gap ends
+    auto wakeAt = std::chrono::steady_clock::now()
+                + std::chrono::microseconds((long long)((idleS - m_wakeLeadS) * 1e6));
+    
+    // Already in standby: a shorter gap only brings the wake-up forward;
+    // the power thread wakes at once if that is already past
+    if (m_inStandby) {
+        if (wakeAt < m_wakeAt) {
+            m_wakeAt = wakeAt;
+            m_powerCv.notify_all();
+        }
+        return;
+    }
+    
+    if (idleS < m_wakeLeadS * STANDBY_MIN_IDLE_FACTOR) {
+        return;
+    }
+    
+    status = sc5511a_set_standby(dev_handle, 1);
+    if (status != SUCCESS) {
+        noteDeviceError(status);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to enter standby" << std::endl;
+        return;
+    }
+    m_inStandby = true;
+    m_standbyGauge.set(1.0);
+    sampleTemperature();
+    std::cout << "[SignalCoreSC5511A Plugin] RF1 in standby for " << idleS << " s" << std::endl;
+    
+    m_wakeAt = wakeAt;
+    if (!m_powerThread.joinable()) {
+        m_powerThreadStop = false;
+        m_powerThread = std::thread(&SignalCoreSC5511A::powerThreadLoop, this);
+    }
+    m_powerCv.notify_all();
+}
+
+// Called before device commands: a command that arrives before the
+// scheduled wake-up pays the restabilization time itself. Errors are
+// raised after m_powerMutex is released, so onError handlers may call
+// back into the plugin.
+void SignalCoreSC5511A::ensureAwake()
+{
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_powerMutex);
+        error.swap(m_powerError);
+        if (m_inStandby) {
+            std::cout << "[SignalCoreSC5511A Plugin] Command during standby, waking now" << std::endl;
+            std::string wakeError = wakeLocked();
+            if (!wakeError.empty()) {
+                error = wakeError;
+            }
+        }
+    }
+    if (!error.empty() && onError) {
+        onError(error);
+    }
+}
+
+// Leaves standby and waits until the PLLs lock again. The measured time
+// feeds the wake lead: it follows slower wake-ups at once and relaxes
+// slowly after faster ones. Runs on the power thread too, so it uses no
+// shared status and raises no callback; the error message is returned.
+std::string SignalCoreSC5511A::wakeLocked()
+{
+    auto start = std::chrono::steady_clock::now();
+    int result = sc5511a_set_standby(dev_handle, 0);
+    m_inStandby = false;
+    m_standbyGauge.set(0.0);
+    if (result != SUCCESS) {
+        noteDeviceError(result);
+        std::cerr << "[SignalCoreSC5511A Plugin] Failed to leave standby" << std::endl;
+        return "Failed to leave standby";
+    }
+    
+    auto deadline = start + std::chrono::microseconds((long long)(STANDBY_WAKE_TIMEOUT_S * 1e6));
+    bool locked = false;
+    while (isLocked(locked) && !locked && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double wakeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (locked) {
+        double lead = wakeS * STANDBY_LEAD_MARGIN;
+        m_wakeLeadS = lead > m_wakeLeadS ? lead : 0.7 * m_wakeLeadS + 0.3 * lead;
+        std::cout << "[SignalCoreSC5511A Plugin] RF1 awake, locked after " << wakeS * 1e3 << " ms" << std::endl;
+        return std::string();
+    }
+    std::cerr << "[SignalCoreSC5511A Plugin] PLL did not lock after standby" << std::endl;
+    return "PLL did not lock after standby";
+}
+
+void SignalCoreSC5511A::powerThreadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_powerMutex);
+    while (!m_powerThreadStop) {
+        if (!m_inStandby) {
+            m_powerCv.wait(lock);
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= m_wakeAt) {
+            // Raised from the next host call, not from this thread
+            std::string error = wakeLocked();
+            if (!error.empty()) {
+                m_powerError = error;
+            }
+            sampleTemperature();
+            continue;
+        }
+        // Keep the temperature gauge current through long standby gaps
+        auto nextSample = m_lastTemperatureSample + std::chrono::seconds(TEMPERATURE_SAMPLE_INTERVAL_S);
+        if (now >= nextSample) {
+            sampleTemperature();
+            continue;
+        }
+        m_powerCv.wait_until(lock, nextSample < m_wakeAt ? nextSample : m_wakeAt);
+    }
+}
+
+void SignalCoreSC5511A::stopPowerThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_powerMutex);
+        m_powerThreadStop = true;
+    }
+    m_powerCv.notify_all();
+    if (m_powerThread.joinable()) {
+        m_powerThread.join();
+    }
+}
+
+bool SignalCoreSC5511A::setSettledMode(bool enabled, double timeoutMs)
+{
+    m_settledMode = enabled;
+    m_settleTimeoutMs = timeoutMs > 0.0 ? timeoutMs : DEFAULT_SETTLE_TIMEOUT_MS;
+    std::cout << "[SignalCoreSC5511A Plugin] Settled mode " << (enabled ? "enabled" : "disabled")
+              << " (timeout " << m_settleTimeoutMs << " ms)" << std::endl;
+    return true;
+}
+
+// Reads the PLL lock detect bits. Only the coarse loop used by the current
+// RF1 lock mode is checked; the other one is idle and reports unlocked.
+bool SignalCoreSC5511A::isLocked(bool &locked)
+{
+    device_status_t deviceStatus;
+    int result = sc5511a_get_device_status(dev_handle, &deviceStatus);
+    if (result != SUCCESS) {
+        noteDeviceError(result);
+        return false;
+    }
+    
+    const pll_status_t &pll = deviceStatus.pll_status;
+    bool coarseLocked = deviceStatus.operate_status.rf1_lock_mode == 0 ? pll.crs_pll_ld : pll.crs_aux_pll_ld;
+    locked = pll.sum_pll_ld && pll.fine_pll_ld && pll.crs_ref_pll_ld && pll.ref_100_pll_ld && coarseLocked;
+    return true;
+}
+
+// Polls lock status with exponential backoff until locked or timed out.
+// The lock time is measured from the start of the frequency write, so it
+// includes the USB transfer and is resolved to the current poll interval.
+bool SignalCoreSC5511A::waitForLock(std::chrono::steady_clock::time_point start, double &lockTimeUs)
+{
+    auto deadline = start + std::chrono::microseconds((long long)(m_settleTimeoutMs * 1000.0));
+    
+    // Skip polls that are known to report unlocked
+    if (m_typicalLockUs > 0.0) {
+        std::this_thread::sleep_until(start + std::chrono::microseconds(
+            (long long)(m_typicalLockUs * LOCK_FIRST_POLL_FRACTION)));
+    }
+    
+    long long intervalUs = LOCK_POLL_INITIAL_US;
+    while (true) {
+        bool locked = false;
+        if (!isLocked(locked)) {
+            std::cerr << "[SignalCoreSC5511A Plugin] Failed to read PLL status" << std::endl;
+            if (onError) {
+                onError("Failed to read PLL status");
+            }
+            return false;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (locked) {
+            lockTimeUs = std::chrono::duration<double, std::micro>(now - start).count();
+            m_typicalLockUs = m_typicalLockUs > 0.0 ? 0.8 * m_typicalLockUs + 0.2 * lockTimeUs : lockTimeUs;
+            m_lockTimeGauge.set(lockTimeUs);
+            std::cout << "[SignalCoreSC5511A Plugin] PLL locked after " << lockTimeUs << " us" << std::endl;
+            return true;
+        }
+        if (now >= deadline) {
+            m_lockTimeoutCounter.add();
+            std::cerr << "[SignalCoreSC5511A Plugin] PLL did not lock within " << m_settleTimeoutMs << " ms" << std::endl;
+            if (onError) {
+                onError("PLL did not lock");
+            }
+            return false;
+        }
+        
+        auto next = now + std::chrono::microseconds(intervalUs);
+        std::this_thread::sleep_until(next < deadline ? next : deadline);
+        intervalUs = intervalUs * 2 < LOCK_POLL_MAX_US ? intervalUs * 2 : LOCK_POLL_MAX_US;
+    }
+}
+
 // Factory functions for plugin loading
 extern "C" {
     #ifdef _WIN32
@@ -26,8 +26,14 @@
 
 #include <Windows.h>  // Required for HANDLE type used by sc5511a.h
 #include "iplugininterface.h"
+#include "common/pluginmetrics.h"
 #include "sc5511a.h"
+#include "sc5511adevicepool.h"
 #include <string>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 class SignalCoreSC5511A : public ISignalGeneratorPlugin
 {
@@ -47,25 +53,98 @@ public:
     // Configuration
     void setFreq(double freqHz) override;
     void setPower(double powerDbm) override;
+    bool getPower(double &powerDbm) const override;
     
     // RF Control
     void enableRf() override;
     void disableRf() override;
     bool isRfEnabled() const override;
     
+    // Settled mode (poll PLL lock after every frequency change)
+    bool setSettledMode(bool enabled, double timeoutMs) override;
+    
+    // Channel 0 is RF1, channel 1 is the fixed-level RF2 output
+    int channelCount() const override;
+    bool channelInfo(int channel, ChannelInfo &info) const override;
+    bool setChannelFreq(int channel, double freqHz) override;
+    bool setChannelPower(int channel, double powerDbm) override;
+    bool setChannelRfEnabled(int channel, bool enabled) override;
+    bool isChannelRfEnabled(int channel) const override;
+    
+    // Fast hopping through sc5511a_reg_write(RF_FREQUENCY)
+    bool loadHopTable(const std::vector<double> &freqsHz) override;
+    bool hopTo(size_t index) override;
+    bool setHopVerification(bool enabled) override;
+    
+    // List mode with fingerprinted RAM/EEPROM list caching
+    bool loadFreqList(const std::vector<double> &freqsHz) override;
+    bool startFreqList(double dwellS, unsigned int cycles) override;
+    bool stopFreqList() override;
+    
+    // Trigger routing for list sweeps (TRIG IN / TRIG OUT pins)
+    bool setTriggerOut(TriggerOutMode mode) override;
+    bool setTriggerIn(TriggerInMode mode) override;
+    
+    // Predictive standby between scans
+    bool announceIdle(double idleS) override;
+    
 private:
+    void sampleTemperature();
+    void noteDeviceError(int result);
+    bool isLocked(bool &locked);
+    bool waitForLock(std::chrono::steady_clock::time_point start, double &lockTimeUs);
+    bool uploadList(const std::vector<unsigned long long> &words);
+    bool verifyList(const std::vector<unsigned long long> &words);
+    void ensureAwake();
+    void announceIdleLocked(double idleS);
+    std::string wakeLocked();
+    void stopPowerThread();
+    void powerThreadLoop();
+    
     bool m_isConnected;
     bool m_rfEnabled;
     double m_freqHz;
     double m_powerDbm;
     std::string m_connectedAddress;
+    bool m_rf2Enabled;
+    double m_rf2FreqHz;
 
     // sc5511a specific handle
     sc5511a_device_handle_t dev_handle; //device handle
 	int input; // user input to select the device found
 	int num_of_devices; // the number of device types found
-	char **device_list;  // 2D to hold serial numbers of the devices found 
 	int i, status; // status reporting of functions
+    bool m_deviceError; // USB error seen; the handle is discarded, not pooled
+
+    // Health metrics published to the shared-memory metrics segment
+    MetricGauge m_temperatureGauge;
+    std::chrono::steady_clock::time_point m_lastTemperatureSample;
+    MetricGauge m_lockTimeGauge;
+    MetricCounter m_lockTimeoutCounter;
+
+    // Settled mode
+    bool m_settledMode;
+    double m_settleTimeoutMs;
+    double m_typicalLockUs; // running estimate, used to delay the first poll
+
+    // Hop table: RF_FREQUENCY values (Hz, as setFreq() sends them)
+    std::vector<unsigned long long> m_hopWords;
+    bool m_hopVerify;
+
+    // Trigger routing, applied to list_mode_t by startFreqList()
+    TriggerOutMode m_triggerOut;
+    TriggerInMode m_triggerIn;
+
+    // Standby management; the power thread issues scheduled wake-ups
+    std::mutex m_powerMutex;
+    std::condition_variable m_powerCv;
+    std::thread m_powerThread;
+    bool m_powerThreadStop;
+    bool m_inStandby;
+    std::chrono::steady_clock::time_point m_wakeAt;
+    double m_wakeLeadS;     // restabilization time plus margin, learned on wake-up
+    std::string m_powerError;   // failed scheduled wake-up, reported on the next host call
+    MetricGauge m_standbyGauge;
 
 };
 
@@ -8,10 +8,24 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <Windows.h>
 #include "iplugininterface.h"
+#include "common/instrumentedplugins.h"
+#include "common/calibration.h"
+#include "common/channelmeasurements.h"
+#include "common/clocksync.h"
+#include "common/powersweep.h"
+#include "common/scalarnetworkanalysis.h"
+#include "common/scanplanner.h"
+#include "common/adaptivescan.h"
+#include "common/arrayfactor.h"
+#include "common/traceaveraging.h"
 
 // Function pointer types for plugin factory functions
 typedef ISignalGeneratorPlugin* (*CreateSignalGeneratorFunc)();
@@ -31,7 +45,8 @@ std::vector<PluginInfo> g_plugins = {
     {"SignalCore SC5511A", "../../signalgenerator/signalcore_sc5511a/build/Release/signalcore_sc5511a.dll", "signalgenerator"},
     {"Dummy Signal Generator", "../../signalgenerator/dummy/build/Release/dummy.dll", "signalgenerator"},
     {"Dummy Signal Analyzer", "../../signalanalyzer/dummy/build/Release/dummy.dll", "signalanalyzer"},
-    {"Dummy Positioner", "../../positioner/dummy/build/Release/dummy.dll", "positioner"}
+    {"Dummy Positioner", "../../positioner/dummy/build/Release/dummy.dll", "positioner"},
+    {"Host Utilities (mock instruments)", "", "host"}
 };
 
 // Test Signal Generator Plugin
@@ -59,13 +74,18 @@ void testSignalGeneratorPlugin(const std::string& pluginPath) {
     }
     
     // Create plugin instance
-    ISignalGeneratorPlugin* plugin = createFunc();
-    if (!plugin) {
+    ISignalGeneratorPlugin* rawPlugin = createFunc();
+    if (!rawPlugin) {
         std::cerr << "Failed to create plugin instance" << std::endl;
         FreeLibrary(hModule);
         return;
     }
     
+    // Wrap the plugin to collect per-method latency statistics
+    InstrumentedSignalGenerator* instrumented = new InstrumentedSignalGenerator(rawPlugin, "Signal Generator");
+    instrumented->instrumentation().traceTo(&TraceRecorder::global());
+    ISignalGeneratorPlugin* plugin = instrumented;
+    
     // Set up callbacks
     plugin->onDevicesScanned = [](const std::vector<DeviceInfo>& devices) {
         std::cout << "\n[Callback] Devices scanned: " << devices.size() << " device(s) found" << std::endl;
@@ -125,8 +145,44 @@ void testSignalGeneratorPlugin(const std::string& pluginPath) {
             plugin->disableRf();
             std::cout << "RF Status: " << (plugin->isRfEnabled() ? "ON" : "OFF") << std::endl;
             
-            // Test 8: Disconnect
-            std::cout << "\n[Test 8] Disconnecting..." << std::endl;
+            // Test 8: Frequency hopping, fast path against setFreq()
+            std::cout << "\n[Test 8] Hop rate (200 hops, 1-6 GHz)..." << std::endl;
+            std::vector<double> hopFreqs;
+            for (int i = 0; i < 200; i++) {
+                hopFreqs.push_back(1.0e9 + (i * 37 % 200) * 25.0e6);
+            }
+            if (plugin->loadHopTable(hopFreqs)) {
+                auto wrapperStart = std::chrono::steady_clock::now();
+                for (double freq : hopFreqs) {
+                    plugin->setFreq(freq);
+                }
+                double wrapperS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wrapperStart).count();
+                
+                auto hopStart = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < hopFreqs.size(); i++) {
+                    plugin->hopTo(i);
+                }
+                double hopS = std::chrono::duration<double>(std::chrono::steady_clock::now() - hopStart).count();
+                
+                std::cout << "setFreq(): " << hopFreqs.size() / wrapperS << " hops/s" << std::endl;
+                std::cout << "hopTo():   " << hopFreqs.size() / hopS << " hops/s" << std::endl;
+                
+                // Read every hop back from the device
+                plugin->setHopVerification(true);
+                size_t verified = 0;
+                for (size_t i = 0; i < 20; i++) {
+                    if (plugin->hopTo(i)) {
+                        verified++;
+                    }
+                }
+                plugin->setHopVerification(false);
+                std::cout << "Verified hops: " << verified << "/20" << std::endl;
+            } else {
+                std::cout << "Plugin has no fast hop path" << std::endl;
+            }
+            
+            // Test 9: Disconnect
+            std::cout << "\n[Test 9] Disconnecting..." << std::endl;
             plugin->disconnect();
         } else {
             std::cerr << "Failed to connect to device" << std::endl;
@@ -144,8 +200,13 @@ void testSignalGeneratorPlugin(const std::string& pluginPath) {
         }
     }
     
+    // Latency statistics
+    std::cout << std::endl;
+    instrumented->instrumentation().dump(std::cout);
+    
     // Cleanup
-    destroyFunc(plugin);
+    delete instrumented;
+    destroyFunc(rawPlugin);
     FreeLibrary(hModule);
     
     std::cout << "\n========================================" << std::endl;
@@ -177,13 +238,18 @@ void testSignalAnalyzerPlugin(const std::string& pluginPath) {
     }
     
     // Create plugin instance
-    ISignalAnalyzerPlugin* plugin = createFunc();
-    if (!plugin) {
+    ISignalAnalyzerPlugin* rawPlugin = createFunc();
+    if (!rawPlugin) {
         std::cerr << "Failed to create plugin instance" << std::endl;
         FreeLibrary(hModule);
         return;
     }
     
+    // Wrap the plugin to collect per-method latency statistics
+    InstrumentedSignalAnalyzer* instrumented = new InstrumentedSignalAnalyzer(rawPlugin, "Signal Analyzer");
+    instrumented->instrumentation().traceTo(&TraceRecorder::global());
+    ISignalAnalyzerPlugin* plugin = instrumented;
+    
     // Set up callbacks
     plugin->onDevicesScanned = [](const std::vector<DeviceInfo>& devices) {
         std::cout << "\n[Callback] Devices scanned: " << devices.size() << " device(s) found" << std::endl;
@@ -234,13 +300,33 @@ void testSignalAnalyzerPlugin(const std::string& pluginPath) {
         peak = plugin->findPeak();
         std::cout << "Peak found: " << peak.frequencyHz/1e6 << " MHz, " << peak.leveldBm << " dBm" << std::endl;
         
-        // Test 6: Disconnect
-        std::cout << "\n[Test 6] Disconnecting..." << std::endl;
+        // Test 6: Coarse-to-fine peak search
+        std::cout << "\n[Test 6] Finding peak with 1 kHz accuracy (zoom search)..." << std::endl;
+        peak = plugin->findPeakFast(1e3);
+        std::cout << "Peak found: " << peak.frequencyHz/1e6 << " MHz, " << peak.leveldBm << " dBm" << std::endl;
+        
+        // Test 7: Zero-span capture
+        std::cout << "\n[Test 7] Zero-span capture (100 ms at 10 kHz, 5.5 GHz)..." << std::endl;
+        ZeroSpanCapture capture;
+        if (plugin->captureZeroSpan(5.5e9, 100e3, 10e3, 0.1, capture) && !capture.levelsdBm.empty()) {
+            double maxLevel = *std::max_element(capture.levelsdBm.begin(), capture.levelsdBm.end());
+            std::cout << "Captured " << capture.levelsdBm.size() << " samples, max " << maxLevel << " dBm" << std::endl;
+        } else {
+            std::cout << "Zero span not supported by this plugin" << std::endl;
+        }
+        
+        // Test 8: Disconnect
+        std::cout << "\n[Test 8] Disconnecting..." << std::endl;
         plugin->disconnect();
     }
     
+    // Latency statistics
+    std::cout << std::endl;
+    instrumented->instrumentation().dump(std::cout);
+    
     // Cleanup
-    destroyFunc(plugin);
+    delete instrumented;
+    destroyFunc(rawPlugin);
     FreeLibrary(hModule);
     
     std::cout << "\n========================================" << std::endl;
@@ -272,13 +358,18 @@ void testPositionerPlugin(const std::string& pluginPath) {
     }
     
     // Create plugin instance
-    IPositionerPlugin* plugin = createFunc();
-    if (!plugin) {
+    IPositionerPlugin* rawPlugin = createFunc();
+    if (!rawPlugin) {
         std::cerr << "Failed to create plugin instance" << std::endl;
         FreeLibrary(hModule);
         return;
     }
     
+    // Wrap the plugin to collect per-method latency statistics
+    InstrumentedPositioner* instrumented = new InstrumentedPositioner(rawPlugin, "Positioner");
+    instrumented->instrumentation().traceTo(&TraceRecorder::global());
+    IPositionerPlugin* plugin = instrumented;
+    
     // Set up callbacks
     plugin->onDevicesScanned = [](const std::vector<DeviceInfo>& devices) {
         std::cout << "\n[Callback] Devices scanned: " << devices.size() << " device(s) found" << std::endl;
@@ -304,6 +395,10 @@ void testPositionerPlugin(const std::string& pluginPath) {
         std::cout << "[Callback] Movement stopped!" << std::endl;
     };
     
+    plugin->onWaypointReached = [](int id, double azimuth, double elevation, double polar) {
+        std::cout << "[Callback] Waypoint " << id << " reached: Az=" << azimuth << "°, El=" << elevation << "°, Polar=" << polar << "°" << std::endl;
+    };
+    
     plugin->onError = [](const std::string& error) {
         std::cout << "[Callback] Error: " << error << std::endl;
     };
@@ -337,13 +432,35 @@ void testPositionerPlugin(const std::string& pluginPath) {
         plugin->moveTo(0.0, 0.0);
         std::this_thread::sleep_for(std::chrono::seconds(2));
         
-        // Test 6: Disconnect
-        std::cout << "\n[Test 6] Disconnecting..." << std::endl;
+        // Test 6: Raster path, blending through every row but the last point
+        std::cout << "\n[Test 6] Streaming raster path..." << std::endl;
+        std::vector<Waypoint> path;
+        for (int row = 0; row < 3; row++) {
+            double elevation = row * 5.0;
+            for (int col = 0; col <= 4; col++) {
+                double azimuth = (row % 2 == 0) ? col * 5.0 : 20.0 - col * 5.0;
+                path.push_back(Waypoint(azimuth, elevation, 0.0, true, row * 5 + col));
+            }
+        }
+        path.back().blend = false;
+        if (plugin->queueWaypoints(path)) {
+            std::this_thread::sleep_for(std::chrono::seconds(6));
+        } else {
+            std::cout << "Path streaming not supported" << std::endl;
+        }
+        
+        // Test 7: Disconnect
+        std::cout << "\n[Test 7] Disconnecting..." << std::endl;
         plugin->disconnect();
     }
     
+    // Latency statistics
+    std::cout << std::endl;
+    instrumented->instrumentation().dump(std::cout);
+    
     // Cleanup
-    destroyFunc(plugin);
+    delete instrumented;
+    destroyFunc(rawPlugin);
     FreeLibrary(hModule);
     
     std::cout << "\n========================================" << std::endl;
@@ -351,11 +468,540 @@ void testPositionerPlugin(const std::string& pluginPath) {
     std::cout << "========================================\n" << std::endl;
 }
 
+// Mock instruments for the host utilities: an amplifier with 20 dB gain
+// and soft compression towards +20 dBm, measured without any delay
+class MockGenerator : public ISignalGeneratorPlugin
+{
+public:
+    MockGenerator() : powerDbm(-50.0), rfEnabled(false), setPowerCalls(0) {}
+    
+    std::vector<DeviceInfo> scanDevices() override { return std::vector<DeviceInfo>(); }
+    bool connectToDevice(const std::string &address) override { (void)address; return true; }
+    bool connect() override { return true; }
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+    void setFreq(double freqHz) override { (void)freqHz; }
+    void setPower(double level) override { powerDbm = level; setPowerCalls++; }
+    bool getPower(double &level) const override { level = powerDbm; return true; }
+    void enableRf() override { rfEnabled = true; }
+    void disableRf() override { rfEnabled = false; }
+    bool isRfEnabled() const override { return rfEnabled; }
+    
+    double powerDbm;
+    bool rfEnabled;
+    int setPowerCalls;
+};
+
+class MockAnalyzer : public ISignalAnalyzerPlugin
+{
+public:
+    explicit MockAnalyzer(const MockGenerator &generator) : m_generator(generator) {}
+    
+    std::vector<DeviceInfo> scanDevices() override { return std::vector<DeviceInfo>(); }
+    bool connectToDevice(const std::string &address) override { (void)address; return true; }
+    bool connect() override { return true; }
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+    void setStartFreq(double freqHz) override { (void)freqHz; }
+    void setStopFreq(double freqHz) override { (void)freqHz; }
+    void setRBW(double freqHz) override { (void)freqHz; }
+    Peak findPeak() override
+    {
+        Peak peak;
+        peak.frequencyHz = 1.0e9;
+        double linear = m_generator.rfEnabled ? std::pow(10.0, (m_generator.powerDbm + 20.0) / 10.0) : 1e-12;
+        peak.leveldBm = 10.0 * std::log10(linear / std::sqrt(1.0 + std::pow(linear / 100.0, 2.0)));
+        return peak;
+    }
+    
+private:
+    const MockGenerator &m_generator;
+};
+
+// Analyzer returning traces of exponential noise (mean 0 dBm per bin) with
+// a constant 20 dBm tone at 1 GHz, the middle of 101 bins
+class NoiseAnalyzer : public ISignalAnalyzerPlugin
+{
+public:
+    NoiseAnalyzer() : traces(0), m_random(42), m_noise(1.0) {}
+    
+    std::vector<DeviceInfo> scanDevices() override { return std::vector<DeviceInfo>(); }
+    bool connectToDevice(const std::string &address) override { (void)address; return true; }
+    bool connect() override { return true; }
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+    void setStartFreq(double freqHz) override { (void)freqHz; }
+    void setStopFreq(double freqHz) override { (void)freqHz; }
+    void setRBW(double freqHz) override { (void)freqHz; }
+    Peak findPeak() override
+    {
+        Peak peak;
+        peak.frequencyHz = 1.0e9;
+        peak.leveldBm = 20.0;
+        return peak;
+    }
+    bool readTrace(Trace &trace) override
+    {
+        trace.startFreqHz = 1.0e9 - 500.0e3;
+        trace.stopFreqHz = 1.0e9 + 500.0e3;
+        trace.rbwHz = 10.0e3;
+        trace.levelsdBm.resize(101);
+        for (size_t i = 0; i < trace.levelsdBm.size(); i++) {
+            trace.levelsdBm[i] = 10.0 * std::log10(m_noise(m_random) + (i == 50 ? 100.0 : 0.0));
+        }
+        traces++;
+        return true;
+    }
+    
+    int traces;
+    
+private:
+    std::mt19937 m_random;
+    std::exponential_distribution<double> m_noise;
+};
+
+static void check(bool passed, const std::string &what, int &failures)
+{
+    std::cout << (passed ? "  PASS: " : "  FAIL: ") << what << std::endl;
+    if (!passed) {
+        failures++;
+    }
+}
+
+// Generator with a frequency list for the S21 sweep. Every trigger the
+// analyzer waits for steps the list; skipTriggerAt loses the pulse of
+// that list point, so the analyzer measures the following one instead.
+class ListGenerator : public MockGenerator
+{
+public:
+    ListGenerator() : freqHz(0.0), skipTriggerAt(-1), m_listRunning(false), m_listIndex(0), m_triggerOut(TriggerOutMode::Off) {}
+    
+    void setFreq(double hz) override { freqHz = hz; }
+    bool loadFreqList(const std::vector<double> &freqsHz) override { m_list = freqsHz; return true; }
+    bool startFreqList(double dwellS, unsigned int cycles) override
+    {
+        (void)dwellS;
+        (void)cycles;
+        m_listRunning = !m_list.empty();
+        m_listIndex = 0;
+        return m_listRunning;
+    }
+    bool stopFreqList() override { m_listRunning = false; return true; }
+    bool setTriggerOut(TriggerOutMode mode) override { m_triggerOut = mode; return true; }
+    bool setTriggerIn(TriggerInMode mode) override { (void)mode; return true; }
+    
+    // Next trigger out pulse; false once the list has ended
+    bool trigger()
+    {
+        if (!m_listRunning || m_triggerOut == TriggerOutMode::Off) {
+            return false;
+        }
+        if ((int)m_listIndex == skipTriggerAt) {
+            m_listIndex++;
+        }
+        if (m_listIndex >= m_list.size()) {
+            return false;
+        }
+        freqHz = m_list[m_listIndex++];
+        return true;
+    }
+    
+    double freqHz;
+    int skipTriggerAt;
+    
+private:
+    std::vector<double> m_list;
+    bool m_listRunning;
+    size_t m_listIndex;
+    TriggerOutMode m_triggerOut;
+};
+
+// S21 of the mock device under test: -3 dB at DC falling 2 dB per GHz
+static double mockS21dB(double freqHz)
+{
+    return -3.0 - 2.0 * freqHz / 1.0e9;
+}
+
+// Analyzer seeing the generator tone through the mock device; with a
+// StartSweep trigger every findPeak() waits for the next list step
+class S21Analyzer : public ISignalAnalyzerPlugin
+{
+public:
+    explicit S21Analyzer(ListGenerator &generator) : m_generator(generator), m_triggered(false) {}
+    
+    std::vector<DeviceInfo> scanDevices() override { return std::vector<DeviceInfo>(); }
+    bool connectToDevice(const std::string &address) override { (void)address; return true; }
+    bool connect() override { return true; }
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+    void setStartFreq(double freqHz) override { (void)freqHz; }
+    void setStopFreq(double freqHz) override { (void)freqHz; }
+    void setRBW(double freqHz) override { (void)freqHz; }
+    bool setTriggerIn(TriggerInMode mode, double timeoutS) override
+    {
+        (void)timeoutS;
+        m_triggered = mode == TriggerInMode::StartSweep;
+        return true;
+    }
+    Peak findPeak() override
+    {
+        Peak peak;
+        if ((m_triggered && !m_generator.trigger()) || !m_generator.rfEnabled) {
+            return peak;
+        }
+        peak.frequencyHz = m_generator.freqHz;
+        peak.leveldBm = m_generator.powerDbm + mockS21dB(m_generator.freqHz);
+        return peak;
+    }
+    
+private:
+    ListGenerator &m_generator;
+    bool m_triggered;
+};
+
+// Equal within the tolerance, or the same infinity / both NaN
+static bool sameValue(double actual, double expected, double tolerance)
+{
+    if (std::isnan(expected)) {
+        return std::isnan(actual);
+    }
+    if (std::isinf(expected)) {
+        return actual == expected;
+    }
+    return std::fabs(actual - expected) <= tolerance;
+}
+
+// Test the host utilities against mock instruments
+void testHostUtilities() {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "Testing Host Utilities (mock instruments)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    int failures = 0;
+    MockGenerator generator;
+    MockAnalyzer analyzer(generator);
+    PowerSweep powerSweep(generator, analyzer);
+    
+    // Test 1: Empty sweep leaves the generator alone
+    std::cout << "\n[Test 1] Power sweep over an empty level list..." << std::endl;
+    std::vector<PowerSweepPoint> points;
+    bool ok = powerSweep.sweep(std::vector<double>(), points);
+    check(ok && points.empty(), "returns true without points", failures);
+    check(generator.setPowerCalls == 0 && generator.powerDbm == -50.0, "generator level untouched", failures);
+    
+    // Test 2: Sweep restores the previous level and RF state
+    std::cout << "\n[Test 2] Power sweep -30..-10 dBm from -50 dBm, RF off..." << std::endl;
+    std::vector<double> levels = { -30.0, -20.0, -10.0 };
+    ok = powerSweep.sweep(levels, points);
+    check(ok && points.size() == levels.size(), "three points measured", failures);
+    check(points.size() == 3 && std::fabs(points[0].gaindB - 20.0) < 0.01, "small-signal gain 20 dB", failures);
+    check(generator.powerDbm == -50.0 && !generator.rfEnabled, "level and RF state restored", failures);
+    
+    // Test 3: Invalid search settings are rejected
+    std::cout << "\n[Test 3] Compression search with tolerancedB = 0..." << std::endl;
+    PowerSweepSettings settings;
+    settings.tolerancedB = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    CompressionResult result = powerSweep.findCompression(settings);
+    double elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    check(!result.ok && result.measurements == 0 && elapsedS < 1.0, "rejected without measuring", failures);
+    
+    // Test 4: P1dB of the mock amplifier
+    std::cout << "\n[Test 4] P1dB search..." << std::endl;
+    settings = PowerSweepSettings();
+    result = powerSweep.findCompression(settings);
+    // 1 dB compression where sqrt(1 + (L / 100 mW)^2) = 10^0.1, L the linear output in mW
+    double expectedInput = 10.0 * std::log10(100.0 * std::sqrt(std::pow(10.0, 0.2) - 1.0)) - 20.0;
+    std::cout << "  Input P1dB: " << result.inputCompressiondBm << " dBm (expected " << expectedInput << " dBm), "
+              << result.measurements << " measurements" << std::endl;
+    check(result.ok && result.found && std::fabs(result.inputCompressiondBm - expectedInput) < 0.1, "P1dB within 0.1 dB", failures);
+    check(generator.powerDbm == -50.0 && !generator.rfEnabled, "level and RF state restored", failures);
+    
+    // Test 5: SIMD kernels against the C library, every length so each
+    // value passes through both the vector lanes and the scalar tail
+    std::cout << "\n[Test 5] SIMD dB conversions against std::pow / std::log10..." << std::endl;
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> dBm = { -400.0, -300.0, -123.456, -0.5, 0.0, 17.25, 299.9, 400.0, inf, -inf, nan };
+    std::vector<double> mW = { 1e-40, 1e-30, 2.5e-9, 1e-3, 1.0, 3.7, 1e29, inf, nan, 0.0, -1.0 };
+    bool linearMatch = true;
+    bool dbMatch = true;
+    for (size_t offset = 0; offset < 2; offset++) {
+        for (size_t length = 1; offset + length <= dBm.size(); length++) {
+            std::vector<double> out(length);
+            SimdKernels::dbToLinear(dBm.data() + offset, out.data(), length);
+            for (size_t i = 0; i < length; i++) {
+                double expected = std::pow(10.0, dBm[offset + i] / 10.0);
+                linearMatch = linearMatch && sameValue(out[i], expected, 1e-12 * std::fabs(expected));
+            }
+            SimdKernels::linearToDb(mW.data() + offset, out.data(), length);
+            for (size_t i = 0; i < length; i++) {
+                double x = mW[offset + i];
+                double expected = x > 1e-30 || std::isnan(x) ? 10.0 * std::log10(x) : -300.0;
+                dbMatch = dbMatch && sameValue(out[i], expected, 1e-9);
+            }
+        }
+    }
+    check(linearMatch, "dbToLinear matches std::pow, including +-inf and NaN", failures);
+    check(dbMatch, "linearToDb matches std::log10, including inf and NaN", failures);
+    
+    // Test 6: Linear and log averaging of exponentially distributed noise
+    std::cout << "\n[Test 6] Averaging 1000 noise traces of 101 bins..." << std::endl;
+    std::mt19937 random(1234);
+    std::exponential_distribution<double> noise(1.0);
+    TraceAverager linearAverager(TraceAveragingMode::LinearPower);
+    TraceAverager logAverager(TraceAveragingMode::Log);
+    Trace noiseTrace;
+    noiseTrace.startFreqHz = 1.0e9;
+    noiseTrace.stopFreqHz = 1.001e9;
+    noiseTrace.rbwHz = 10.0e3;
+    noiseTrace.levelsdBm.resize(101);
+    for (int sweep = 0; sweep < 1000; sweep++) {
+        for (double &level : noiseTrace.levelsdBm) {
+            level = 10.0 * std::log10(noise(random));
+        }
+        linearAverager.add(noiseTrace);
+        logAverager.add(noiseTrace);
+    }
+    double linearMean = 0.0;
+    double logMean = 0.0;
+    Trace linearResult = linearAverager.result();
+    Trace logResult = logAverager.result();
+    for (size_t i = 0; i < noiseTrace.levelsdBm.size(); i++) {
+        linearMean += linearResult.levelsdBm[i] / noiseTrace.levelsdBm.size();
+        logMean += logResult.levelsdBm[i] / noiseTrace.levelsdBm.size();
+    }
+    // The mean of 10 log10 of an exponential variable is -10 gamma / ln 10
+    double logBias = -10.0 * 0.5772156649 / std::log(10.0);
+    std::cout << "  Linear: " << linearMean << " dBm, log: " << logMean << " dBm (expected 0 and " << logBias << ")" << std::endl;
+    check(std::fabs(linearMean) < 0.1, "linear average is the noise power", failures);
+    check(std::fabs(logMean - logBias) < 0.1, "log average shows the 2.5 dB noise bias", failures);
+    
+    // Test 7: averageTraces stops once the tone is known to 0.1 dB
+    std::cout << "\n[Test 7] Averaging a 20 dBm tone in noise to 0.1 dB..." << std::endl;
+    NoiseAnalyzer noiseAnalyzer;
+    TraceAveragingSettings averaging;
+    TraceAveragingResult averaged = averageTraces(noiseAnalyzer, averaging);
+    std::cout << "  " << averaged.sweeps << " sweeps, peak " << averaged.peak.leveldBm << " dBm at "
+              << averaged.peak.frequencyHz / 1e6 << " MHz, CI " << averaged.confidenceDb << " dB" << std::endl;
+    check(averaged.ok && averaged.converged && averaged.confidenceDb <= 0.1, "converged on the confidence target", failures);
+    check(averaged.sweeps >= averaging.minSweeps && averaged.sweeps < averaging.maxSweeps &&
+          noiseAnalyzer.traces == (int)averaged.sweeps, "stopped before maxSweeps", failures);
+    check(averaged.peak.frequencyHz == 1.0e9 && std::fabs(averaged.peak.leveldBm - 10.0 * std::log10(101.0)) < 0.2,
+          "tone plus noise level at 1 GHz", failures);
+    
+    // Test 8: averageTraces gives up at maxSweeps
+    std::cout << "\n[Test 8] Averaging every bin to 0.01 dB, at most 20 sweeps..." << std::endl;
+    noiseAnalyzer.traces = 0;
+    averaging.scope = TraceAveragingSettings::AllBins;
+    averaging.confidenceDb = 0.01;
+    averaging.maxSweeps = 20;
+    averaged = averageTraces(noiseAnalyzer, averaging);
+    check(averaged.ok && !averaged.converged && averaged.sweeps == 20 && noiseAnalyzer.traces == 20,
+          "stopped at maxSweeps without converging", failures);
+    
+    // Test 9: Channel power of a flat trace, -50 dBm per point with 10 kHz
+    // RBW and 10 kHz point spacing from 995 to 1005 MHz
+    std::cout << "\n[Test 9] Channel power of a flat -50 dBm trace..." << std::endl;
+    Trace flatTrace;
+    flatTrace.startFreqHz = 995.0e6;
+    flatTrace.stopFreqHz = 1005.0e6;
+    flatTrace.rbwHz = 10.0e3;
+    flatTrace.levelsdBm.assign(1001, -50.0);
+    ChannelPowerMeter meter(flatTrace);
+    // Every RBW-wide reading holds the power of 1.065 RBW of the noise
+    double expectedChannel = -50.0 + 10.0 * std::log10(1.0e6 / (ChannelPowerMeter::GaussianNoiseBandwidth * 10.0e3));
+    double channel = meter.channelPowerdBm(1.0e9, 1.0e6);
+    std::cout << "  1 MHz channel: " << channel << " dBm (expected " << expectedChannel << " dBm)" << std::endl;
+    check(std::fabs(channel - expectedChannel) < 1e-6, "matches -50 dBm + 10 log10(B / 1.065 RBW)", failures);
+    
+    // Test 10: Occupied bandwidth edges of the flat channel
+    std::cout << "\n[Test 10] 99 % occupied bandwidth within 999.5..1000.5 MHz..." << std::endl;
+    double obwLowHz = 0.0;
+    double obwHighHz = 0.0;
+    ok = meter.occupiedBandwidth(999.5e6, 1000.5e6, 99.0, obwLowHz, obwHighHz);
+    std::cout << "  Edges: " << obwLowHz / 1e6 << " .. " << obwHighHz / 1e6 << " MHz" << std::endl;
+    check(ok && std::fabs(obwLowHz - 999.505e6) < 1.0 && std::fabs(obwHighHz - 1000.495e6) < 1.0,
+          "0.5 % of the power outside either edge", failures);
+    
+    // Test 11: ACPR complete flag follows the trace coverage
+    std::cout << "\n[Test 11] ACPR with 1 MHz channels at 2 MHz spacing..." << std::endl;
+    AcprResult acpr = meter.acpr(1.0e9, 1.0e6, 2.0e6, 1.0e6, 2);
+    check(acpr.complete && acpr.lowerdBc.size() == 2 && std::fabs(acpr.lowerdBc[1]) < 1e-6 &&
+          std::fabs(acpr.upperdBc[1]) < 1e-6, "two pairs inside the trace, 0 dBc on a flat trace", failures);
+    acpr = meter.acpr(1.0e9, 1.0e6, 2.0e6, 1.0e6, 3);
+    check(!acpr.complete && acpr.upperdBc.size() == 3 && acpr.upperdBc[2] < -1.0,
+          "third pair beyond the trace edge is flagged and clipped", failures);
+    
+    // Test 12: S21 sweep paced by the generator list
+    std::cout << "\n[Test 12] S21 sweep 1..2 GHz, 11 points, list mode..." << std::endl;
+    ListGenerator listGenerator;
+    S21Analyzer s21Analyzer(listGenerator);
+    ScalarNetworkAnalyzer networkAnalyzer(listGenerator, s21Analyzer);
+    S21SweepSettings s21Settings;
+    for (int i = 0; i <= 10; i++) {
+        s21Settings.freqsHz.push_back(1.0e9 + i * 100.0e6);
+    }
+    s21Settings.sourcePowerdBm = -10.0;
+    s21Settings.triggerWired = true;
+    s21Settings.dwellS = 0.001;
+    S21Trace s21 = networkAnalyzer.sweep(s21Settings);
+    bool s21Match = s21.s21dB.size() == s21Settings.freqsHz.size();
+    for (size_t i = 0; s21Match && i < s21.s21dB.size(); i++) {
+        s21Match = std::fabs(s21.s21dB[i] - mockS21dB(s21Settings.freqsHz[i])) < 1e-9;
+    }
+    std::cout << "  " << s21.listPoints << " list points, S21 " << s21.s21dB.front() << " .. " << s21.s21dB.back() << " dB" << std::endl;
+    check(s21.ok && s21.listPoints == 10, "all points after the first paced by the list", failures);
+    check(s21Match, "S21 matches the device under test", failures);
+    check(!listGenerator.rfEnabled && listGenerator.powerDbm == -10.0, "RF switched off again", failures);
+    
+    // Test 13: A missed trigger hands the rest of the sweep to stepped mode
+    std::cout << "\n[Test 13] S21 sweep with the trigger of point 5 lost..." << std::endl;
+    listGenerator.skipTriggerAt = 4;
+    s21 = networkAnalyzer.sweep(s21Settings);
+    s21Match = s21.s21dB.size() == s21Settings.freqsHz.size();
+    for (size_t i = 0; s21Match && i < s21.s21dB.size(); i++) {
+        s21Match = std::fabs(s21.s21dB[i] - mockS21dB(s21Settings.freqsHz[i])) < 1e-9;
+    }
+    std::cout << "  " << s21.listPoints << " list points" << std::endl;
+    check(s21.ok && s21.listPoints == 4, "points 1-4 from the list, the rest stepped", failures);
+    check(s21Match, "S21 matches the device under test", failures);
+    
+    // Test 14: The planned scan is no slower than any plain raster
+    std::cout << "\n[Test 14] Scan plan for AZ -60..60 x EL -20..20 in 10 deg steps, 3 frequencies..." << std::endl;
+    PositionerCostModel positionerCost;
+    positionerCost.az.velocity = 20.0;
+    positionerCost.az.acceleration = 40.0;
+    positionerCost.az.backlashDeg = 0.3;
+    positionerCost.el.velocity = 10.0;
+    positionerCost.el.acceleration = 20.0;
+    GeneratorCostModel generatorCost;
+    ScanPlanner planner(positionerCost, generatorCost, 0.01);
+    ScanGrid grid = ScanGrid::make(-60.0, 60.0, 10.0, -20.0, 20.0, 10.0);
+    std::vector<double> scanFreqsHz = { 1.0e9, 2.0e9, 3.0e9 };
+    ScanPlan best = planner.plan(grid, scanFreqsHz);
+    bool noSlower = true;
+    double slowestRasterS = 0.0;
+    for (const ScanPlan &candidate : planner.candidatePlans(grid, scanFreqsHz)) {
+        if (candidate.strategy.compare(0, 6, "raster") == 0) {
+            noSlower = noSlower && best.durationS <= candidate.durationS;
+            slowestRasterS = candidate.durationS > slowestRasterS ? candidate.durationS : slowestRasterS;
+        }
+    }
+    std::cout << "  Best: " << best.strategy << ", " << best.durationS << " s (slowest raster " << slowestRasterS << " s)" << std::endl;
+    check(best.steps.size() == grid.size() * scanFreqsHz.size(), "every angle and frequency planned", failures);
+    check(noSlower, "no slower than plain raster", failures);
+    
+    // Test 15: Adaptive AZ cut of a Gaussian lobe, 12 deg wide at -3 dB,
+    // centered off the coarse grid at 7 deg
+    std::cout << "\n[Test 15] Adaptive cut of a 12 deg Gaussian lobe..." << std::endl;
+    AdaptiveScanSettings adaptiveSettings;
+    AdaptiveScanner scanner(adaptiveSettings);
+    int probes = 0;
+    AdaptiveScanResult adaptive = scanner.run([&probes](const ScanAngle &angle, double &levelDb) {
+        double offset = (angle.az - 7.0) / 6.0;
+        levelDb = -3.0 * offset * offset;
+        levelDb = levelDb > -40.0 ? levelDb : -40.0;
+        probes++;
+        return true;
+    });
+    PatternMetrics adaptiveMetrics = adaptive.metrics(0.05);
+    std::cout << "  " << probes << " points, peak at " << adaptiveMetrics.peakAz << " deg, -3 dB width "
+              << adaptiveMetrics.beamwidthAzDeg << " deg" << std::endl;
+    check(adaptive.complete() && std::fabs(adaptiveMetrics.beamwidthAzDeg - 12.0) < 0.1, "-3 dB width within 0.1 deg", failures);
+    check(probes < 361, "fewer points than a uniform 0.5 deg cut", failures);
+    
+    // Test 16: CalibrationTable::resample against valueAt, on grids that
+    // extend past both ends of an unevenly spaced table, in both directions
+    std::cout << "\n[Test 16] Calibration table resampled onto sweep grids..." << std::endl;
+    CalibrationTable cable("cable");
+    cable.addPoint(3.0e9, -4.2);
+    cable.addPoint(1.0e9, -1.5);
+    cable.addPoint(1.3e9, -1.9);
+    cable.addPoint(3.01e9, -4.6);
+    cable.addPoint(2.05e9, -2.8);
+    cable.addPoint(4.0e9, -5.1);
+    bool resampleMatch = true;
+    std::vector<double> lut(1001);
+    const double grids[2][2] = { { 0.5e9, 4.5e9 }, { 4.5e9, 0.5e9 } };
+    for (const auto &range : grids) {
+        cable.resample(range[0], range[1], lut.size(), -1.0, lut.data());
+        for (size_t i = 0; i < lut.size(); i++) {
+            double freq = range[0] + (range[1] - range[0]) * i / (lut.size() - 1);
+            resampleMatch = resampleMatch && std::fabs(lut[i] + cable.valueAt(freq)) < 1e-12;
+        }
+    }
+    check(resampleMatch, "resample matches valueAt on rising and falling grids", failures);
+    
+    // Test 17: ClockSync recovers a fixed offset from exchanges with 20 to
+    // 100 us round trips, the remote reading anywhere inside the round trip
+    std::cout << "\n[Test 17] Clock sync against a remote clock 3.7 s ahead..." << std::endl;
+    const uint64_t remoteOffsetNs = 3700000000ULL;
+    std::uniform_int_distribution<uint64_t> roundTrip(20000, 100000);
+    std::uniform_real_distribution<double> readPoint(0.0, 1.0);
+    ClockSync clockSync;
+    uint64_t hostNs = 1000000000ULL;
+    for (int i = 0; i < 64; i++) {
+        uint64_t rttNs = roundTrip(random);
+        uint64_t remoteNs = hostNs + (uint64_t)(readPoint(random) * rttNs) + remoteOffsetNs;
+        clockSync.addExchange(hostNs, remoteNs, hostNs + rttNs);
+        hostNs += 10000000ULL;
+    }
+    double offsetErrorNs = clockSync.offsetNs(hostNs) - (double)remoteOffsetNs;
+    int64_t backErrorNs = (int64_t)(clockSync.toHostNs(hostNs + remoteOffsetNs) - hostNs);
+    std::cout << "  Offset error " << offsetErrorNs / 1e3 << " us, uncertainty " << clockSync.uncertaintyNs() / 1e3
+              << " us, drift " << clockSync.driftPpm() << " ppm" << std::endl;
+    check(std::fabs(offsetErrorNs) < 50000.0, "offset within half the longest round trip", failures);
+    check(backErrorNs > -50000 && backErrorNs < 50000, "remote timestamps map back to host time", failures);
+    
+    // Test 18: 8 x 8 lambda/2 array at 5.5 GHz with cos^1.5 elements
+    std::cout << "\n[Test 18] 8 x 8 array factor..." << std::endl;
+    ArrayFactor array;
+    double halfWavelengthM = 299792458.0 / 5.5e9 / 2.0;
+    array.setElements(ArrayFactor::rectangularArray(8, 8, halfWavelengthM, halfWavelengthM));
+    double elementPeakdBi = 10.0 * std::log10(2.0 * (1.5 + 1.0));
+    double broadside = array.gaindBi(0.0, 0.0);
+    std::cout << "  Broadside: " << broadside << " dBi (expected " << elementPeakdBi + 10.0 * std::log10(64.0) << " dBi)" << std::endl;
+    check(std::fabs(broadside - elementPeakdBi - 10.0 * std::log10(64.0)) < 1e-9, "broadside gain is 64 x element gain", failures);
+    
+    // Threaded SIMD evaluation against the scalar single-direction path,
+    // compared in linear power relative to the peak so nulls do not count
+    array.steer(20.0, -10.0);
+    array.setThreadCount(4);
+    std::vector<double> patternAz;
+    std::vector<double> patternEl;
+    for (int e = 0; e <= 40; e++) {
+        for (int a = 0; a <= 100; a++) {
+            patternAz.push_back(-90.0 + 1.8 * a);
+            patternEl.push_back(-60.0 + 3.0 * e);
+        }
+    }
+    std::vector<double> pattern(patternAz.size());
+    array.evaluate(patternAz.data(), patternEl.data(), pattern.data(), pattern.size());
+    double peakLinear = std::pow(10.0, broadside / 10.0);
+    double worstError = 0.0;
+    for (size_t i = 0; i < pattern.size(); i++) {
+        double scalar = array.gaindBi(patternAz[i], patternEl[i]);
+        double error = std::fabs(std::pow(10.0, pattern[i] / 10.0) - std::pow(10.0, scalar / 10.0)) / peakLinear;
+        worstError = error > worstError ? error : worstError;
+    }
+    std::cout << "  " << pattern.size() << " directions, worst difference " << worstError << " of the peak" << std::endl;
+    check(worstError < 1e-12, "threaded SIMD evaluate matches scalar gaindBi", failures);
+    
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "Host Utilities Test Complete: " << (failures == 0 ? "all passed" : std::to_string(failures) + " failed") << std::endl;
+    std::cout << "========================================\n" << std::endl;
+}
+
 int main() {
     std::cout << "======================================" << std::endl;
     std::cout << "    Plugin Test Application" << std::endl;
     std::cout << "======================================\n" << std::endl;
     
+    // Record a timeline of all plugin calls (open in ui.perfetto.dev)
+    TraceRecorder::global().setThreadName("main");
+    TraceRecorder::global().start();
+    
     // Display available plugins
     std::cout << "Available Plugins:" << std::endl;
     for (size_t i = 0; i < g_plugins.size(); i++) {
@@ -382,6 +1028,8 @@ int main() {
                 testSignalAnalyzerPlugin(plugin.path);
             } else if (plugin.type == "positioner") {
                 testPositionerPlugin(plugin.path);
+            } else if (plugin.type == "host") {
+                testHostUtilities();
             }
             std::cout << "\nPress Enter to continue...";
             std::cin.ignore();
@@ -397,9 +1045,16 @@ int main() {
             testSignalAnalyzerPlugin(plugin.path);
         } else if (plugin.type == "positioner") {
             testPositionerPlugin(plugin.path);
+        } else if (plugin.type == "host") {
+            testHostUtilities();
         }
     }
     
+    TraceRecorder::global().stop();
+    if (TraceRecorder::global().writeFile("plugin_trace.json")) {
+        std::cout << "\nTimeline written to plugin_trace.json (" << TraceRecorder::global().eventCount() << " events)" << std::endl;
+    }
+    
     std::cout << "\nAll tests complete! Press Enter to exit...";
     std::cin.ignore();
     std::cin.get();